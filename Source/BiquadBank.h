@@ -0,0 +1,136 @@
+//
+//  BiquadBank.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef BiquadBank_h
+#define BiquadBank_h
+
+#include <math.h>
+#include "FilterDesigner.h"
+
+// Size cascades of Stages biquads each, transposed direct form II, laid out like OnePoleBank:
+// every coefficient and state variable is one array over the Size filters, so a stage of
+// the whole bank is one loop without dependencies between its iterations, which the compiler
+// runs as SIMD. The coefficients are plain values set from the thread that processes.
+template <int Size, int Stages>
+class BiquadBank
+{
+
+public:
+    BiquadBank()
+    {
+        FilterCoefficients flat = { { 1, 0, 0, 1, 0, 0 } };
+        for (int stage = 0; stage < Stages; stage++)
+        {
+            for (int index = 0; index < Size; index++)
+            {
+                setCoefficients(stage, index, flat);
+            }
+        }
+        reset();
+    };
+
+    ~BiquadBank()
+    {
+    };
+
+    void reset();
+    // --- stage of filter index, the numerator is scaled by gain on top
+    void setCoefficients(int stage, int index, const FilterCoefficients& coefficients, float gain = 1);
+
+    // --- one step of every cascade, input and output hold one value per filter
+    void processFrame(const float* input, float* output);
+    // --- numSamples steps of every cascade, one row per filter
+    void processBlock(const float* const* input, float* const* output, int numSamples);
+
+private:
+    static float snapToZero(float value)
+    {
+        return fabsf(value) > 1.0e-8f ? value : 0.0f;
+    }
+
+    // --- numerator, and denominator without its leading 1
+    float mA0[Stages][Size];
+    float mA1[Stages][Size];
+    float mA2[Stages][Size];
+    float mB1[Stages][Size];
+    float mB2[Stages][Size];
+
+    float mState1[Stages][Size];
+    float mState2[Stages][Size];
+};
+
+template <int Size, int Stages>
+void BiquadBank<Size, Stages>::reset()
+{
+    for (int stage = 0; stage < Stages; stage++)
+    {
+        for (int index = 0; index < Size; index++)
+        {
+            mState1[stage][index] = 0;
+            mState2[stage][index] = 0;
+        }
+    }
+}
+
+template <int Size, int Stages>
+void BiquadBank<Size, Stages>::setCoefficients(int stage, int index, const FilterCoefficients& coefficients, float gain)
+{
+    auto normalize = 1.0f / coefficients[3];
+    mA0[stage][index] = coefficients[0] * normalize * gain;
+    mA1[stage][index] = coefficients[1] * normalize * gain;
+    mA2[stage][index] = coefficients[2] * normalize * gain;
+    mB1[stage][index] = coefficients[4] * normalize;
+    mB2[stage][index] = coefficients[5] * normalize;
+}
+
+template <int Size, int Stages>
+inline void BiquadBank<Size, Stages>::processFrame(const float* input, float* output)
+{
+    float signal[Size];
+    for (int index = 0; index < Size; index++)
+    {
+        signal[index] = input[index];
+    }
+
+    for (int stage = 0; stage < Stages; stage++)
+    {
+        for (int index = 0; index < Size; index++)
+        {
+            auto x = signal[index];
+            auto y = snapToZero(mA0[stage][index] * x + mState1[stage][index]);
+            mState1[stage][index] = mA1[stage][index] * x - mB1[stage][index] * y + mState2[stage][index];
+            mState2[stage][index] = mA2[stage][index] * x - mB2[stage][index] * y;
+            signal[index] = y;
+        }
+    }
+
+    for (int index = 0; index < Size; index++)
+    {
+        output[index] = signal[index];
+    }
+}
+
+template <int Size, int Stages>
+inline void BiquadBank<Size, Stages>::processBlock(const float* const* input, float* const* output, int numSamples)
+{
+    for (int i = 0; i < numSamples; i++)
+    {
+        float frame[Size];
+        for (int index = 0; index < Size; index++)
+        {
+            frame[index] = input[index][i];
+        }
+        processFrame(frame, frame);
+        for (int index = 0; index < Size; index++)
+        {
+            output[index][i] = frame[index];
+        }
+    }
+}
+
+#endif /* BiquadBank_h */
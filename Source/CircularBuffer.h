@@ -9,7 +9,23 @@
 #ifndef CircularBuffer_h
 #define CircularBuffer_h
 
+#include <algorithm>
+#include "Interpolation.h"
+#include "SampleStorage.h"
+
+// --- a block of the delay memory, split into at most two contiguous pieces at the wrap point
 template <typename T>
+struct CircularBufferSpan
+{
+    T* first;
+    int firstLength;
+    T* second;
+    int secondLength;
+};
+
+// --- Interpolator picks the kernel of the fractional reads at compile time, see Interpolation.h
+// --- Storage is the sample format kept in memory, see SampleStorage.h
+template <typename T, typename Interpolator = HermiteInterpolation, typename Storage = T>
 class CircularBuffer
 {
 
@@ -26,65 +42,114 @@ public:
     };
     
     void createCircularBuffer(unsigned int input);
+    void createCircularBuffer(unsigned int input, Storage* memory);
+    static unsigned int getRequiredLength(unsigned int input);
     void flushBuffer();
     void writeBuffer(T input);
     
     T readBuffer(int delayInSamples);
     T readBuffer(double delayInFractionalSamples, bool interpolate = true);
+
+    CircularBufferSpan<Storage> getWriteSpan(int numSamples);
+    CircularBufferSpan<const Storage> getReadSpan(int delayInSamples, int numSamples) const;
+    void advanceWriteIndex(int numSamples);
+    void writeBlock(const T* input, int numSamples);
+    void readBlock(T* output, int delayInSamples, int numSamples) const;
+    void readBlock(T* output, double delayStart, double delayEnd, int numSamples);
+    void readBlock(T* output, const float* delayInFractionalSamples, int numSamples);
     
     float doLinearInterpolation(float delayInFractionalSamples);
     float doHermitInterpolation(float delayInFractionalSamples);
     float doLagrangeInterpolation(float delayInFractionalSamples);
     
+    // --- the first samples are mirrored past the end, so a 4-point kernel never wraps
+    static const int kGuardSamples = 4;
+
 private:
-    std::unique_ptr<T[]> mBuffer = nullptr;
+    const Storage* getTaps(int offset, int index) const;
+    void updateGuardSamples();
+    T readInterpolatedAt(int offset, float delayInFractionalSamples);
+
+    Interpolator mInterpolator;
+    SampleEncoder<Storage> mEncoder;
+
+    // --- mBuffer either points into mOwnedBuffer or into memory handed in from outside
+    std::unique_ptr<Storage[]> mOwnedBuffer = nullptr;
+    Storage* mBuffer = nullptr;
     unsigned int mWriteIndex;
     unsigned int mBufferLength;
     unsigned int mWrapMask;
 };
 
-template <typename T>
-void CircularBuffer<T>::createCircularBuffer(unsigned int input)
+template <typename T, typename Interpolator, typename Storage>
+unsigned int CircularBuffer<T, Interpolator, Storage>::getRequiredLength(unsigned int input)
+{
+    // --- buffer length as power of 2, plus the mirrored guard samples
+    return (unsigned int)(pow(2, ceil(logf(input) / logf(2)))) + kGuardSamples;
+}
+
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::createCircularBuffer(unsigned int input)
 {
+    // --- direct initialization object into the required size
+    mOwnedBuffer.reset(new Storage[getRequiredLength(input)]);
+    createCircularBuffer(input, mOwnedBuffer.get());
+}
+
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::createCircularBuffer(unsigned int input, Storage* memory)
+{
+    // --- memory has to hold getRequiredLength(input) samples and outlive the buffer
+    if (memory != mOwnedBuffer.get())
+    {
+        mOwnedBuffer.reset();
+    }
+    mBuffer = memory;
     // --- reset the to top
     mWriteIndex = 0;
     // --- init buffer length as power of 2
-    mBufferLength = (unsigned int)(pow(2, ceil(logf(input) / logf(2))));
+    mBufferLength = getRequiredLength(input) - kGuardSamples;
     // --- warp mask as (mBufferLength - 1) for binary &= calculation
     mWrapMask = mBufferLength - 1;
-    // --- direct initialization object into mBufferLength size
-    mBuffer.reset(new T[mBufferLength]);
     // --- clean the value inside mBuffer
     flushBuffer();
 }
 
-template <typename T>
-void CircularBuffer<T>::flushBuffer()
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::flushBuffer()
 {
-    for (int i = 0; i < mBufferLength; i++)
+    for (int i = 0; i < mBufferLength + kGuardSamples; i++)
     {
-        mBuffer[i] = 0;
+        mBuffer[i] = Storage();
     }
+    mInterpolator.reset();
+    mEncoder.reset();
 }
 
-template <typename T>
-void CircularBuffer<T>::writeBuffer(T input)
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::writeBuffer(T input)
 {
-    mBuffer[mWriteIndex++] = input;
+    Storage encoded = mEncoder.encode(input);
+    // --- keep the mirror of the first samples in step
+    if (mWriteIndex < kGuardSamples)
+    {
+        mBuffer[mWriteIndex + mBufferLength] = encoded;
+    }
+    mBuffer[mWriteIndex++] = encoded;
     mWriteIndex &= mWrapMask;
 }
 
-template<typename T>
-T CircularBuffer<T>::readBuffer(int delayInSamples)
+template <typename T, typename Interpolator, typename Storage>
+T CircularBuffer<T, Interpolator, Storage>::readBuffer(int delayInSamples)
 {
     int readIndex = mWriteIndex - delayInSamples;
     readIndex &= mWrapMask;
-    return mBuffer[readIndex];
+    return (T)mBuffer[readIndex];
 }
 
-template<typename T>
+template <typename T, typename Interpolator, typename Storage>
 // --- read an arbitrary location that includes a fractional sample
-T CircularBuffer<T>::readBuffer(double delayInFractionalSamples, bool interpolate /*= true*/)
+T CircularBuffer<T, Interpolator, Storage>::readBuffer(double delayInFractionalSamples, bool interpolate /*= true*/)
 {
     // --- truncate delayInFractionalSamples and read the int part
     T y1 = readBuffer((int)delayInFractionalSamples);
@@ -93,65 +158,129 @@ T CircularBuffer<T>::readBuffer(double delayInFractionalSamples, bool interpolat
     {
         return y1;
     }
-    // --- else do interpolation
+    // --- else do interpolation with the kernel chosen by Interpolator
     else
     {
-        return doHermitInterpolation(delayInFractionalSamples);
+        return readInterpolatedAt(0, delayInFractionalSamples);
     }
 }
 
-template<typename T>
-float CircularBuffer<T>::doLinearInterpolation(float delayInFractionalSamples)
+// --- the block methods below see the block the way the per-sample loop would: sample i of a
+// --- read is taken i samples after the current write position, as if the first i samples of
+// --- the block had already been written. Read a block before writing it, and keep the delay
+// --- longer than the block, otherwise the read touches samples which are not written yet.
+template <typename T, typename Interpolator, typename Storage>
+CircularBufferSpan<Storage> CircularBuffer<T, Interpolator, Storage>::getWriteSpan(int numSamples)
 {
-    float y1 = readBuffer((int)delayInFractionalSamples);
-    float y2 = readBuffer((int)delayInFractionalSamples + 1);
-    float fraction = delayInFractionalSamples - (int)delayInFractionalSamples;
+    int firstLength = std::min(numSamples, (int)(mBufferLength - mWriteIndex));
+    return { mBuffer + mWriteIndex, firstLength, mBuffer, numSamples - firstLength };
+}
 
-    if (fraction >= 1.0) return y2;
-    return fraction * y2 + (1 - fraction) * y1;
+template <typename T, typename Interpolator, typename Storage>
+CircularBufferSpan<const Storage> CircularBuffer<T, Interpolator, Storage>::getReadSpan(int delayInSamples, int numSamples) const
+{
+    unsigned int readIndex = (mWriteIndex - delayInSamples) & mWrapMask;
+    int firstLength = std::min(numSamples, (int)(mBufferLength - readIndex));
+    return { mBuffer + readIndex, firstLength, mBuffer, numSamples - firstLength };
 }
 
-template<typename T>
-float CircularBuffer<T>::doHermitInterpolation(float delayInFractionalSamples)
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::advanceWriteIndex(int numSamples)
 {
-    int index = (int)delayInFractionalSamples;
-    float xm1 = readBuffer(index - 1);;
-    float x0 = readBuffer(index);
-    float x1 = readBuffer(index + 1);
-    float x2 = readBuffer(index + 2);
+    // --- commit samples which were written through getWriteSpan()
+    mWriteIndex = (mWriteIndex + numSamples) & mWrapMask;
+    updateGuardSamples();
+}
 
-    float frac_pos = delayInFractionalSamples - (int)delayInFractionalSamples;
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::updateGuardSamples()
+{
+    std::copy(mBuffer, mBuffer + kGuardSamples, mBuffer + mBufferLength);
+}
 
-    const float c = (x1 - xm1) * 0.5f;
-    const float v = x0 - x1;
-    const float w = c + v;
-    const float a = w + v + (x2 - x0) * 0.5f;
-    const float b_neg = w + a;
-    return ((((a * frac_pos) - b_neg) * frac_pos + c) * frac_pos + x0);
+template <typename T, typename Interpolator, typename Storage>
+const Storage* CircularBuffer<T, Interpolator, Storage>::getTaps(int offset, int index) const
+{
+    // --- x2, x1, x0, xm1 of a read at delay index lie in ascending order from here
+    return mBuffer + ((mWriteIndex + offset - index - 2) & mWrapMask);
 }
 
-template<typename T>
-float CircularBuffer<T>::doLagrangeInterpolation(float delayInFractionalSamples)
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::writeBlock(const T* input, int numSamples)
 {
-    int n = 4;
-    int index = (int)delayInFractionalSamples;
-    float x[4] = { index - 1, index, index + 1, index + 2 };
-    float y[4] = { readBuffer(index - 1), readBuffer(index), readBuffer(index + 1), readBuffer(index + 2) };
+    auto span = getWriteSpan(numSamples);
+    for (int i = 0; i < span.firstLength; i++)
+    {
+        span.first[i] = mEncoder.encode(input[i]);
+    }
+    for (int i = 0; i < span.secondLength; i++)
+    {
+        span.second[i] = mEncoder.encode(input[span.firstLength + i]);
+    }
+    advanceWriteIndex(numSamples);
+}
+
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::readBlock(T* output, int delayInSamples, int numSamples) const
+{
+    auto span = getReadSpan(delayInSamples, numSamples);
+    for (int i = 0; i < span.firstLength; i++)
+    {
+        output[i] = (T)span.first[i];
+    }
+    for (int i = 0; i < span.secondLength; i++)
+    {
+        output[span.firstLength + i] = (T)span.second[i];
+    }
+}
+
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::readBlock(T* output, double delayStart, double delayEnd, int numSamples)
+{
+    // --- ramp the delay linearly from delayStart to delayEnd across the block
+    double increment = (delayEnd - delayStart) / numSamples;
+    for (int i = 0; i < numSamples; i++)
+    {
+        output[i] = readInterpolatedAt(i, (float)(delayStart + increment * i));
+    }
+}
 
-    float interpolation = 0;
-    for (int i = 0; i < n; i++)
+template <typename T, typename Interpolator, typename Storage>
+void CircularBuffer<T, Interpolator, Storage>::readBlock(T* output, const float* delayInFractionalSamples, int numSamples)
+{
+    for (int i = 0; i < numSamples; i++)
     {
-        float term = y[i];
-        for (int j = 0; j < n; j++)
-        {
-            if (j != i)
-            {
-                term = term * (delayInFractionalSamples - x[j]) / (float)(x[i] - x[j]);
-            }
-        }
-        interpolation += term;
+        output[i] = readInterpolatedAt(i, delayInFractionalSamples[i]);
     }
-    return interpolation;
+}
+
+template <typename T, typename Interpolator, typename Storage>
+T CircularBuffer<T, Interpolator, Storage>::readInterpolatedAt(int offset, float delayInFractionalSamples)
+{
+    int index = (int)delayInFractionalSamples;
+    return mInterpolator.interpolate(getTaps(offset, index), 1, delayInFractionalSamples - index);
+}
+
+// --- the fixed kernels below stay available whatever Interpolator the buffer was built with
+template <typename T, typename Interpolator, typename Storage>
+float CircularBuffer<T, Interpolator, Storage>::doLinearInterpolation(float delayInFractionalSamples)
+{
+    int index = (int)delayInFractionalSamples;
+    return LinearInterpolation().interpolate(getTaps(0, index), 1, delayInFractionalSamples - index);
+}
+
+template <typename T, typename Interpolator, typename Storage>
+float CircularBuffer<T, Interpolator, Storage>::doHermitInterpolation(float delayInFractionalSamples)
+{
+    int index = (int)delayInFractionalSamples;
+    return HermiteInterpolation().interpolate(getTaps(0, index), 1, delayInFractionalSamples - index);
+}
+
+template <typename T, typename Interpolator, typename Storage>
+float CircularBuffer<T, Interpolator, Storage>::doLagrangeInterpolation(float delayInFractionalSamples)
+{
+    int index = (int)delayInFractionalSamples;
+    return LagrangeInterpolation().interpolate(getTaps(0, index), 1, delayInFractionalSamples - index);
 }
 
 
@@ -0,0 +1,138 @@
+//
+//  ControlRamp.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef ControlRamp_h
+#define ControlRamp_h
+
+// A control signal evaluated once every control rate samples and interpolated linearly in
+// between. next() and process() take the evaluation as a callable, which is only invoked at
+// the control points, so smoothers and modulators behind it run at the control rate and
+// have to be set up for a sample rate divided by it. Each segment glides from the previous
+// evaluation to the one taken at its start and lands on it with its last sample, so the
+// ramp trails by up to one control period; with a control rate of 1 it returns every
+// evaluation as is.
+//
+// When the evaluation is known to keep returning the value the ramp rests on, hold() stands in
+// for process(): it fills the output and keeps the control points in step without calling it,
+// with the same result.
+template <typename T>
+class ControlRamp
+{
+
+public:
+    ControlRamp()
+    {
+        mControlRate = 1;
+        reset();
+    };
+
+    ~ControlRamp()
+    {
+    };
+
+    void setControlRate(int controlRate);
+    int getControlRate();
+    void reset();
+
+    template <typename Evaluate>
+    T next(Evaluate evaluate);
+
+    template <typename Evaluate>
+    void process(T* output, int numSamples, Evaluate evaluate);
+
+    // --- true when the ramp rests on value, so hold() gives what process() would for an evaluation returning value
+    bool isSettled(T value);
+    void hold(T* output, int numSamples);
+
+private:
+    int mControlRate;
+    int mPhase;
+    bool mPrimed;
+    T mStart;
+    T mEnd;
+    T mStep;
+};
+
+template <typename T>
+void ControlRamp<T>::setControlRate(int controlRate)
+{
+    mControlRate = controlRate < 1 ? 1 : controlRate;
+    reset();
+}
+
+template <typename T>
+int ControlRamp<T>::getControlRate()
+{
+    return mControlRate;
+}
+
+template <typename T>
+void ControlRamp<T>::reset()
+{
+    mPhase = 0;
+    mPrimed = false;
+    mStart = 0;
+    mEnd = 0;
+    mStep = 0;
+}
+
+template <typename T>
+template <typename Evaluate>
+inline T ControlRamp<T>::next(Evaluate evaluate)
+{
+    if (mPhase == 0)
+    {
+        mStart = mEnd;
+        mEnd = evaluate();
+        // --- the very first segment holds its value instead of ramping up from zero
+        if (!mPrimed)
+        {
+            mStart = mEnd;
+            mPrimed = true;
+        }
+        mStep = (mEnd - mStart) / mControlRate;
+    }
+
+    mPhase++;
+    if (mPhase == mControlRate)
+    {
+        mPhase = 0;
+        return mEnd;
+    }
+    return mStart + mStep * mPhase;
+}
+
+template <typename T>
+template <typename Evaluate>
+inline void ControlRamp<T>::process(T* output, int numSamples, Evaluate evaluate)
+{
+    for (int i = 0; i < numSamples; i++)
+    {
+        output[i] = next(evaluate);
+    }
+}
+
+template <typename T>
+bool ControlRamp<T>::isSettled(T value)
+{
+    return mPrimed && mEnd == value && (mPhase == 0 || mStart == mEnd);
+}
+
+template <typename T>
+inline void ControlRamp<T>::hold(T* output, int numSamples)
+{
+    for (int i = 0; i < numSamples; i++)
+    {
+        output[i] = mEnd;
+    }
+    mStart = mEnd;
+    mStep = 0;
+    mPhase = (mPhase + numSamples) % mControlRate;
+}
+
+#endif /* ControlRamp_h */
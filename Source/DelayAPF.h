@@ -11,7 +11,7 @@
 #ifndef DelayAPF_h
 #define DelayAPF_h
 
-template <typename T>
+template <typename T, typename Interpolator = HermiteInterpolation, typename Storage = T>
 class DelayAPF: public CircularBuffer<T>
 {
     
@@ -33,11 +33,11 @@ public:
     
     T processSchroeder(T sample, T delaySample, float delayGain);
     T processGerzon(T sample, T delaySample, float delayGain);
-    CircularBuffer<T> digitalDelayLine;
+    CircularBuffer<T, Interpolator, Storage> digitalDelayLine;
 };
 
-template <typename T>
-inline T DelayAPF<T>::processSchroeder(T sample, T delaySample, float delayGain)
+template <typename T, typename Interpolator, typename Storage>
+inline T DelayAPF<T, Interpolator, Storage>::processSchroeder(T sample, T delaySample, float delayGain)
 {
     auto delayedSample = digitalDelayLine.readBuffer(delaySample);
     digitalDelayLine.writeBuffer(sample + (delayedSample * delayGain));
@@ -47,8 +47,8 @@ inline T DelayAPF<T>::processSchroeder(T sample, T delaySample, float delayGain)
 }
 
 
-template <typename T>
-inline T DelayAPF<T>::processGerzon(T sample, T delaySample, float delayGain)
+template <typename T, typename Interpolator, typename Storage>
+inline T DelayAPF<T, Interpolator, Storage>::processGerzon(T sample, T delaySample, float delayGain)
 {
     auto delayedSample = digitalDelayLine.readBuffer(delaySample);
     digitalDelayLine.writeBuffer(sample + (delayedSample * delayGain));
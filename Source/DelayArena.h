@@ -0,0 +1,101 @@
+//
+//  DelayArena.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef DelayArena_h
+#define DelayArena_h
+
+#include <memory>
+#include <string.h>
+
+// One cache-aligned block of memory that is carved up into the delay lines of a processor.
+// All lines of an instance live next to each other in a single allocation, which is touched
+// once up front, so the audio thread never takes a page fault on first use of a line.
+class DelayArena
+{
+
+public:
+    DelayArena()
+    {
+        mData = nullptr;
+        mSize = 0;
+        mOffset = 0;
+    };
+
+    ~DelayArena()
+    {
+    };
+
+    void allocate(size_t numBytes);
+    // --- allocate only if numBytes exceeds what is held already, otherwise just rewind
+    void reserve(size_t numBytes);
+    void rewind();
+    size_t getSize();
+
+    template <typename T>
+    T* take(size_t numElements);
+
+    // --- round numBytes up to the alignment every piece handed out by take() starts on
+    static size_t align(size_t numBytes);
+    static const size_t kAlignment = 64;
+
+private:
+    std::unique_ptr<char[]> mMemory = nullptr;
+    char* mData;
+    size_t mSize;
+    size_t mOffset;
+};
+
+inline void DelayArena::allocate(size_t numBytes)
+{
+    // --- over-allocate so the start can be moved up to the next cache line
+    mMemory.reset(new char[numBytes + kAlignment]);
+    mData = mMemory.get() + (kAlignment - (size_t)mMemory.get() % kAlignment) % kAlignment;
+    mSize = numBytes;
+    mOffset = 0;
+    // --- pre-fault every page now rather than on the audio thread
+    memset(mData, 0, mSize);
+}
+
+inline void DelayArena::reserve(size_t numBytes)
+{
+    if (numBytes > mSize)
+    {
+        allocate(numBytes);
+    }
+    rewind();
+}
+
+inline void DelayArena::rewind()
+{
+    mOffset = 0;
+}
+
+inline size_t DelayArena::getSize()
+{
+    return mSize;
+}
+
+template <typename T>
+inline T* DelayArena::take(size_t numElements)
+{
+    size_t numBytes = align(numElements * sizeof(T));
+    if (mOffset + numBytes > mSize)
+    {
+        return nullptr;
+    }
+    T* piece = reinterpret_cast<T*>(mData + mOffset);
+    mOffset += numBytes;
+    return piece;
+}
+
+inline size_t DelayArena::align(size_t numBytes)
+{
+    return (numBytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+#endif /* DelayArena_h */
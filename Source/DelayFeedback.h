@@ -11,7 +11,7 @@
 #ifndef DelayFeedback_h
 #define DelayFeedback_h
 
-template <typename T>
+template <typename T, typename Interpolator = HermiteInterpolation, typename Storage = T>
 class DelayFeedback: public CircularBuffer<T>
 {
     
@@ -32,11 +32,12 @@ public:
     };
     
     T process(double input, float timeCtrl, float feedbackCtrl, float mixCtrl);
-    CircularBuffer<T> digitalDelayLine;
+    void processBlock(const T* input, T* output, const float* timeCtrl, int numSamples, float feedbackCtrl, float mixCtrl);
+    CircularBuffer<T, Interpolator, Storage> digitalDelayLine;
 };
 
-template <typename T>
-T DelayFeedback<T>::process(double input, float timeCtrl, float feedbackCtrl, float mixCtrl)
+template <typename T, typename Interpolator, typename Storage>
+T DelayFeedback<T, Interpolator, Storage>::process(double input, float timeCtrl, float feedbackCtrl, float mixCtrl)
 {
     // load dry signal from channelData
     auto drySignal = input;
@@ -48,4 +49,39 @@ T DelayFeedback<T>::process(double input, float timeCtrl, float feedbackCtrl, fl
     return wetSignal * mixCtrl + drySignal * (1 - mixCtrl);
 }
 
-#endif /* DelayFeedback_h */
+template <typename T, typename Interpolator, typename Storage>
+void DelayFeedback<T, Interpolator, Storage>::processBlock(const T* input, T* output, const float* timeCtrl, int numSamples, float feedbackCtrl, float mixCtrl)
+{
+    // wet signal and feedback of the current chunk, input and output may point to the same memory
+    T wetSignal[256];
+    T feedbackSignal[256];
+
+    int start = 0;
+    while (start < numSamples)
+    {
+        // grow the chunk while every tap still reads samples written before the chunk,
+        // so reading the whole chunk first and writing it afterwards matches process()
+        int length = 1;
+        while (length < 256 && start + length < numSamples && length + 2 <= (int)timeCtrl[start + length])
+        {
+            length++;
+        }
+
+        // read wet signal from delay line
+        digitalDelayLine.readBlock(wetSignal, timeCtrl + start, length);
+        // sum up the dry signal + wet signal and write in the dely line
+        for (int i = 0; i < length; i++)
+        {
+            feedbackSignal[i] = input[start + i] + wetSignal[i] * feedbackCtrl;
+        }
+        digitalDelayLine.writeBlock(feedbackSignal, length);
+        // adjust the dry and wet portion
+        for (int i = 0; i < length; i++)
+        {
+            output[start + i] = wetSignal[i] * mixCtrl + input[start + i] * (1 - mixCtrl);
+        }
+        start += length;
+    }
+}
+
+#endif /* DelayFeedback_h */
\ No newline at end of file
@@ -0,0 +1,626 @@
+//
+//  FeedbackDelayNetwork.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef FeedbackDelayNetwork_h
+#define FeedbackDelayNetwork_h
+
+#include <JuceHeader.h>
+#include <numeric>
+#include "FilterDesigner.h"
+#include "MultiLineDelay.h"
+#include "LfoBank.h"
+#include "WavetableOscillator.h"
+#include "ControlRamp.h"
+#include "OnePoleBank.h"
+#include "BiquadBank.h"
+#include "PrimeDelayTable.h"
+
+// The time-varying N-line network, N a power of two: modulated taps, one-pole damping and
+// decay per line, and a hadamard feedback matrix applied as an in-place fast walsh-hadamard
+// transform, N log N additions instead of N * N multiply-adds. The transform adds in pairs,
+// (a + b) + (c + d) where a row of the matrix would sum ((a + b) + c) + d, so for N = 4 it
+// matches the hand-written 4 x 4 matrix of the original network up to rounding, not bit for bit.
+//
+// Lanes networks with independent audio but the same controls run side by side, one per
+// channel. They share the modulators, the tap positions and the sub-block split, and their
+// lines sit next to each other in memory, line by line, so a frame of the delay holds
+// line 0 of every lane, then line 1 of every lane, and so on.
+//
+// The modulators, one LfoBank for all lines, run at a control rate, once every
+// setControlRate() samples, and the tap positions follow them through linear ramps in between.
+// Lines set to another E_OSCILLATOR_TYPE shape with setModulationShape() take their value from
+// a WavetableOscillator at the same phase instead; all shapes cost about the same per step.
+//
+// The line lengths come from a PrimeDelayTable for the rate given to setSampleRate(), and the
+// modulation depth, in samples at 44.1 kHz, is scaled by the rate of setParameter(), so the
+// network sounds the same at every rate.
+//
+// With setAbsorption() the broadband decay and the shared one-pole damping give way to a
+// cascade of a low and a high shelf per line, designed from a three-band T60 curve and from
+// the length of that line, so every line loses exactly as much per pass as the decay time of
+// each band asks for. The shelves follow the size control once per control period, at its
+// first sample, in both paths.
+//
+// processSample() runs the network one sample at a time. processBlock() runs the same
+// arithmetic stage by stage over sub-blocks: as long as a sub-block is shorter than every
+// tap, no sample of it is read back inside the same sub-block, so all taps can be read
+// first, then filtered, mixed and written as a whole, and every butterfly of the transform
+// becomes a loop over the sub-block. Both paths give bit-identical output.
+//
+// `PuannhiTools bench --filter=fdn` times both paths for N = 4, 8, 16 and 32, with one lane
+// and with two.
+template <int N, typename Interpolator = HermiteInterpolation, typename Storage = float, int Lanes = 1>
+class FDN
+{
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "FDN needs a power of two number of lines");
+
+public:
+    FDN()
+    {
+        mSpeedCtrl = 0;
+        mDepthCtrl = 0;
+        mDampCtrl = 0;
+        mDecayCtrl = 0;
+        mSampleRate = 44100;
+        mControlRate = 1;
+        mNumWavetableLines = 0;
+        mAbsorptionEnabled = false;
+        mAbsorptionDesigned = false;
+        mAbsorptionCountdown = 0;
+        mDesignedSize = 0;
+        mDesignedRate = 0;
+        setDecayTime(2, 2, 2, 200, 4000);
+        for (int line = 0; line < N; line++)
+        {
+            mShape[line] = E_SINE;
+            mWavetable[line].setPhaseOffset((double)line / N * TWO_PI);
+        }
+        // --- hadamard scaled to a unitary matrix, and the gain of the first line towards the output
+        mMatrixGain = (float)(1.0 / sqrt((double)N));
+        mOutputGain = mMatrixGain * 0.5f;
+        getDelayLengths(mDelayLength, mSampleRate);
+    };
+
+    ~FDN()
+    {
+    };
+
+    static const int kNumLines = N;
+    static const int kNumLanes = Lanes;
+    // --- processBlock() evaluates the modulation for this many samples at a time
+    static const int kMaxBlockSize = 1024 / N < 64 ? 64 : 1024 / N;
+    // --- low shelf, then high shelf
+    static const int kAbsorptionStages = 2;
+
+    static void getDelayLengths(float* lengths, double sampleRate);
+    static float getMaxDelayLength(double sampleRate);
+    static unsigned int getRequiredLength(unsigned int input);
+
+    void createFeedbackDelayNetwork(unsigned int input, Storage* memory);
+    void flushBuffer();
+    // --- the line lengths for sampleRate, 44.1 kHz until set; not while processing
+    void setSampleRate(double sampleRate);
+    // --- mean of the line lengths at the rate of setSampleRate(), without a table lookup or search
+    float getMeanDelayLength() const;
+
+    // --- one-pole damping of every line, y[n] = gain * x[n] + pole * y[n - 1]
+    void setCoefficients(float gain, float pole);
+    void setParameter(float speedCtrl, float depthCtrl, float dampCtrl, float decayCtrl, double sampleRate);
+    // --- evaluate the modulators every controlRate samples, 1 for every sample
+    void setControlRate(int controlRate);
+    // --- E_OSCILLATOR_TYPE of the modulator of line, E_SINE by default
+    void setModulationShape(int line, int model);
+    // --- per-line absorption instead of decay and damping of setParameter(), off by default
+    void setAbsorption(bool enabled);
+    // --- T60 in seconds below lowCrossover, between the crossovers and above highCrossover
+    void setDecayTime(float lowDecayTime, float midDecayTime, float highDecayTime, float lowCrossover, float highCrossover);
+
+    // --- one input and one output per lane
+    void processSample(const float* input, float* output, float sizeCtrl);
+    void processBlock(const float* const* input, float* const* output, const float* sizeCtrl, int numSamples);
+
+    // --- single lane shorthands
+    float processSample(float input, float sizeCtrl);
+    void processBlock(const float* input, float* output, const float* sizeCtrl, int numSamples);
+
+private:
+    void processSubBlock(const float* const* input, float* const* output, int offset, int numSamples);
+    void getModulation(double* modulation);
+    // --- redesigns the shelves when the curve, the size or the sample rate changed
+    void updateAbsorption(float sizeCtrl);
+
+    // --- slot of line in lane, in the delay frames and in the per-line state below
+    static int slot(int line, int lane)
+    {
+        return line * Lanes + lane;
+    }
+
+    MultiLineDelay<float, N * Lanes, Interpolator, Storage> mDelayLines;
+    OnePoleBank<N * Lanes> mFilter;
+    BiquadBank<N * Lanes, kAbsorptionStages> mAbsorption;
+    FilterDesigner mDesigner;
+    bool mAbsorptionEnabled;
+    bool mAbsorptionDesigned;
+    // --- samples until the shelves follow the size control again
+    int mAbsorptionCountdown;
+    // --- the curve of setDecayTime(), then the size and sample rate of the last design
+    float mDecayTime[5];
+    float mDesignedSize;
+    double mDesignedRate;
+    // --- line k is modulated k / N of a period after line 0
+    LfoBank<N> mLfo;
+    double mLfoOutput[N];
+    ControlRamp<double> mModulation[N];
+    // --- run in step with the bank as soon as one line uses them, so they share its phase
+    WavetableOscillator mWavetable[N];
+    int mShape[N];
+    int mNumWavetableLines;
+    float mDelayLength[N];
+    float mMatrixGain;
+    float mOutputGain;
+
+    float mSpeedCtrl;
+    float mDepthCtrl;
+    float mDampCtrl;
+    float mDecayCtrl;
+    double mSampleRate;
+    int mControlRate;
+
+    // --- scratch of processBlock(), tap positions per line, the signal one row per slot
+    float mDelayTime[N][kMaxBlockSize];
+    int mShortestDelay[kMaxBlockSize];
+    float mFeedbackLoop[N * Lanes][kMaxBlockSize];
+    double mMatrix[N * Lanes][kMaxBlockSize];
+    float mFeedbackOutput[N * Lanes][kMaxBlockSize];
+};
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::getDelayLengths(float* lengths, double sampleRate)
+{
+    static constexpr PrimeDelayTable<N> table;
+    table.getLengths(sampleRate, lengths);
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+float FDN<N, Interpolator, Storage, Lanes>::getMaxDelayLength(double sampleRate)
+{
+    float lengths[N];
+    getDelayLengths(lengths, sampleRate);
+    return lengths[N - 1];
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+unsigned int FDN<N, Interpolator, Storage, Lanes>::getRequiredLength(unsigned int input)
+{
+    return MultiLineDelay<float, N * Lanes, Interpolator, Storage>::getRequiredLength(input);
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::createFeedbackDelayNetwork(unsigned int input, Storage* memory)
+{
+    mDelayLines.createMultiLineDelay(input, memory);
+    flushBuffer();
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::flushBuffer()
+{
+    mDelayLines.flushBuffer();
+    mFilter.reset();
+    mAbsorption.reset();
+    mAbsorptionCountdown = 0;
+    mLfo.reset();
+    for (int line = 0; line < N; line++)
+    {
+        mModulation[line].reset();
+        mWavetable[line].reset();
+    }
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::setSampleRate(double sampleRate)
+{
+    mSampleRate = sampleRate;
+    getDelayLengths(mDelayLength, mSampleRate);
+    mAbsorptionDesigned = false;
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+float FDN<N, Interpolator, Storage, Lanes>::getMeanDelayLength() const
+{
+    return std::accumulate(mDelayLength, mDelayLength + N, 0.0f) / N;
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::setCoefficients(float gain, float pole)
+{
+    mFilter.setCoefficients(gain, pole);
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::setParameter(float speedCtrl, float depthCtrl, float dampCtrl, float decayCtrl, double sampleRate)
+{
+    mSpeedCtrl = speedCtrl;
+    mDepthCtrl = (float)(depthCtrl * sampleRate / PrimeDelayTable<N>::kReferenceRate);
+    mDampCtrl = dampCtrl;
+    mDecayCtrl = decayCtrl;
+    mSampleRate = sampleRate;
+    // --- the bank steps once per control period
+    mLfo.setFrequency(mSpeedCtrl, mSampleRate / mControlRate);
+    for (int line = 0; line < N; line++)
+    {
+        mWavetable[line].setFrequency(mSpeedCtrl, mSampleRate / mControlRate);
+    }
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::setControlRate(int controlRate)
+{
+    mControlRate = controlRate < 1 ? 1 : controlRate;
+    mAbsorptionCountdown = 0;
+    for (int line = 0; line < N; line++)
+    {
+        mModulation[line].setControlRate(mControlRate);
+        mWavetable[line].setFrequency(mSpeedCtrl, mSampleRate / mControlRate);
+    }
+    mLfo.setFrequency(mSpeedCtrl, mSampleRate / mControlRate);
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::setModulationShape(int line, int model)
+{
+    jassert(line >= 0 && line < N);
+    mShape[line] = model;
+    mWavetable[line].setShape(model);
+    mNumWavetableLines = 0;
+    for (int index = 0; index < N; index++)
+    {
+        mNumWavetableLines += mShape[index] != E_SINE ? 1 : 0;
+    }
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::setAbsorption(bool enabled)
+{
+    mAbsorptionEnabled = enabled;
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::setDecayTime(float lowDecayTime, float midDecayTime, float highDecayTime, float lowCrossover, float highCrossover)
+{
+    jassert(lowDecayTime > 0 && midDecayTime > 0 && highDecayTime > 0);
+    float curve[5] = { lowDecayTime, midDecayTime, highDecayTime, lowCrossover, highCrossover };
+    for (int index = 0; index < 5; index++)
+    {
+        mAbsorptionDesigned = mAbsorptionDesigned && mDecayTime[index] == curve[index];
+        mDecayTime[index] = curve[index];
+    }
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::updateAbsorption(float sizeCtrl)
+{
+    if (mAbsorptionDesigned && sizeCtrl == mDesignedSize && mSampleRate == mDesignedRate)
+    {
+        return;
+    }
+    mAbsorptionDesigned = true;
+    mDesignedSize = sizeCtrl;
+    mDesignedRate = mSampleRate;
+
+    for (int line = 0; line < N; line++)
+    {
+        // --- attenuation in dB of one pass through this line, per band
+        auto seconds = mDelayLength[line] * sizeCtrl / (float)mSampleRate;
+        auto lowGain = -60 * seconds / mDecayTime[0];
+        auto midGain = -60 * seconds / mDecayTime[1];
+        auto highGain = -60 * seconds / mDecayTime[2];
+
+        // --- the shelves carry the difference of the outer bands, the middle band is broadband
+        mDesigner.model = E_LOW_SHELF;
+        mDesigner.setParameter(mDecayTime[3], (float)mSampleRate, 0.707f, 1, lowGain - midGain);
+        auto lowShelf = mDesigner.getCoefficients();
+        mDesigner.model = E_HIGH_SHELF;
+        mDesigner.setParameter(mDecayTime[4], (float)mSampleRate, 0.707f, 1, highGain - midGain);
+        auto highShelf = mDesigner.getCoefficients();
+
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            mAbsorption.setCoefficients(0, slot(line, lane), lowShelf, powf(10, midGain / 20));
+            mAbsorption.setCoefficients(1, slot(line, lane), highShelf);
+        }
+    }
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+inline void FDN<N, Interpolator, Storage, Lanes>::getModulation(double* modulation)
+{
+    // --- the ramps of all lines share their control points, line 0 comes first and steps the
+    // --- bank for all of them
+    for (int line = 0; line < N; line++)
+    {
+        modulation[line] = mModulation[line].next([this, line]
+        {
+            if (line == 0)
+            {
+                mLfo.process(mLfoOutput);
+                for (int index = 0; index < N && mNumWavetableLines > 0; index++)
+                {
+                    double value = mWavetable[index].process();
+                    mLfoOutput[index] = mShape[index] != E_SINE ? value : mLfoOutput[index];
+                }
+            }
+            return mLfoOutput[line];
+        });
+    }
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::processSample(const float* input, float* output, float sizeCtrl)
+{
+    double modulation[N];
+    getModulation(modulation);
+
+    float delayTime[N * Lanes];
+    for (int line = 0; line < N; line++)
+    {
+        auto time = (float)((mDelayLength[line] + modulation[line] * mDepthCtrl) * sizeCtrl);
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            delayTime[slot(line, lane)] = time;
+        }
+    }
+
+    float feedbackLoop[N * Lanes];
+    mDelayLines.readFrame(feedbackLoop, delayTime);
+
+    double matrix[N * Lanes];
+    if (mAbsorptionEnabled)
+    {
+        float absorbed[N * Lanes];
+        if (mAbsorptionCountdown == 0)
+        {
+            updateAbsorption(sizeCtrl);
+            mAbsorptionCountdown = mControlRate;
+        }
+        mAbsorptionCountdown--;
+        mAbsorption.processFrame(feedbackLoop, absorbed);
+        for (int index = 0; index < N * Lanes; index++)
+        {
+            matrix[index] = absorbed[index] * mMatrixGain;
+        }
+    }
+    else
+    {
+        float lowPass[N * Lanes];
+        mFilter.processFrame(feedbackLoop, lowPass);
+        for (int index = 0; index < N * Lanes; index++)
+        {
+            auto lpf = lowPass[index];
+            auto damp_output = (lpf - feedbackLoop[index]) * mDampCtrl;
+            matrix[index] = (damp_output + feedbackLoop[index]) * mMatrixGain * (mDecayCtrl * 0.25 + 0.75);
+        }
+    }
+
+    // --- the dry signal enters the first two lines
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        matrix[slot(0, lane)] += input[lane];
+        matrix[slot(1, lane)] += input[lane];
+    }
+
+    // --- in-place fast walsh-hadamard transform, lane by lane
+    for (int half = 1; half < N; half *= 2)
+    {
+        for (int first = 0; first < N; first += 2 * half)
+        {
+            for (int line = first; line < first + half; line++)
+            {
+                for (int lane = 0; lane < Lanes; lane++)
+                {
+                    auto x = matrix[slot(line, lane)];
+                    auto y = matrix[slot(line + half, lane)];
+                    matrix[slot(line, lane)] = x + y;
+                    matrix[slot(line + half, lane)] = x - y;
+                }
+            }
+        }
+    }
+
+    // --- the hadamard outputs go straight into the interleaved lines
+    float feedbackFrame[N * Lanes];
+    for (int index = 0; index < N * Lanes; index++)
+    {
+        feedbackFrame[index] = (float)matrix[index];
+    }
+    mDelayLines.writeFrame(feedbackFrame);
+
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        output[lane] = matrix[slot(0, lane)] * mOutputGain;
+    }
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+float FDN<N, Interpolator, Storage, Lanes>::processSample(float input, float sizeCtrl)
+{
+    static_assert(Lanes == 1, "pass one sample per lane");
+    float output;
+    processSample(&input, &output, sizeCtrl);
+    return output;
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::processBlock(const float* input, float* output, const float* sizeCtrl, int numSamples)
+{
+    static_assert(Lanes == 1, "pass one channel per lane");
+    processBlock(&input, &output, sizeCtrl, numSamples);
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::processBlock(const float* const* input, float* const* output, const float* sizeCtrl, int numSamples)
+{
+    for (int start = 0; start < numSamples; start += kMaxBlockSize)
+    {
+        int length = juce::jmin(kMaxBlockSize, numSamples - start);
+
+        // --- modulation and tap positions of the whole piece, and the shortest tap of every sample
+        for (int i = 0; i < length; i++)
+        {
+            double modulation[N];
+            getModulation(modulation);
+
+            float shortest = 0;
+            for (int line = 0; line < N; line++)
+            {
+                mDelayTime[line][i] = (float)((mDelayLength[line] + modulation[line] * mDepthCtrl) * sizeCtrl[start + i]);
+                shortest = line == 0 ? mDelayTime[line][i] : juce::jmin(shortest, mDelayTime[line][i]);
+            }
+            mShortestDelay[i] = (int)shortest;
+        }
+
+        // --- split into sub-blocks in which every tap, including the one sample the 4-point
+        // --- kernels read ahead, lies before the sub-block. A small Size gives short sub-blocks.
+        // --- With absorption a sub-block also ends at a control point, where the shelves
+        // --- follow the size control as in processSample()
+        int offset = 0;
+        while (offset < length)
+        {
+            if (mAbsorptionEnabled && mAbsorptionCountdown == 0)
+            {
+                updateAbsorption(sizeCtrl[start + offset]);
+                mAbsorptionCountdown = mControlRate;
+            }
+            int maxLength = mAbsorptionEnabled ? juce::jmin(length - offset, mAbsorptionCountdown) : length - offset;
+
+            int subLength = 1;
+            while (subLength < maxLength && subLength + 2 <= mShortestDelay[offset + subLength])
+            {
+                subLength++;
+            }
+
+            const float* subInput[Lanes];
+            float* subOutput[Lanes];
+            for (int lane = 0; lane < Lanes; lane++)
+            {
+                subInput[lane] = input[lane] + start + offset;
+                subOutput[lane] = output[lane] + start + offset;
+            }
+            processSubBlock(subInput, subOutput, offset, subLength);
+            offset += subLength;
+            mAbsorptionCountdown -= mAbsorptionEnabled ? subLength : 0;
+        }
+    }
+}
+
+template <int N, typename Interpolator, typename Storage, int Lanes>
+void FDN<N, Interpolator, Storage, Lanes>::processSubBlock(const float* const* input, float* const* output, int offset, int numSamples)
+{
+    // --- read every tap of the sub-block, all lanes of a line at once
+    for (int line = 0; line < N; line++)
+    {
+        float* loop[Lanes];
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            loop[lane] = mFeedbackLoop[slot(line, lane)];
+        }
+        mDelayLines.readBlock(slot(line, 0), Lanes, loop, mDelayTime[line] + offset, numSamples);
+    }
+
+    // --- damping of all slots side by side, into the output rows, which are free until the write
+    const float* feedbackLoop[N * Lanes];
+    float* lowPass[N * Lanes];
+    for (int index = 0; index < N * Lanes; index++)
+    {
+        feedbackLoop[index] = mFeedbackLoop[index];
+        lowPass[index] = mFeedbackOutput[index];
+    }
+    if (mAbsorptionEnabled)
+    {
+        // --- or the absorption shelves, which carry the decay as well
+        mAbsorption.processBlock(feedbackLoop, lowPass, numSamples);
+        for (int index = 0; index < N * Lanes; index++)
+        {
+            for (int i = 0; i < numSamples; i++)
+            {
+                mMatrix[index][i] = lowPass[index][i] * mMatrixGain;
+            }
+        }
+    }
+    else
+    {
+        mFilter.processBlock(feedbackLoop, lowPass, numSamples);
+
+        // --- and decay, slot by slot
+        for (int index = 0; index < N * Lanes; index++)
+        {
+            for (int i = 0; i < numSamples; i++)
+            {
+                auto lpf = lowPass[index][i];
+                auto damp_output = (lpf - mFeedbackLoop[index][i]) * mDampCtrl;
+                mMatrix[index][i] = (damp_output + mFeedbackLoop[index][i]) * mMatrixGain * (mDecayCtrl * 0.25 + 0.75);
+            }
+        }
+    }
+
+    // --- the dry signal enters the first two lines
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        for (int i = 0; i < numSamples; i++)
+        {
+            mMatrix[slot(0, lane)][i] += input[lane][i];
+            mMatrix[slot(1, lane)][i] += input[lane][i];
+        }
+    }
+
+    // --- in-place fast walsh-hadamard transform, each butterfly runs over the whole sub-block
+    // --- of every lane
+    for (int half = 1; half < N; half *= 2)
+    {
+        for (int first = 0; first < N; first += 2 * half)
+        {
+            for (int line = first; line < first + half; line++)
+            {
+                for (int lane = 0; lane < Lanes; lane++)
+                {
+                    double* upper = mMatrix[slot(line, lane)];
+                    double* lower = mMatrix[slot(line + half, lane)];
+                    for (int i = 0; i < numSamples; i++)
+                    {
+                        auto x = upper[i];
+                        auto y = lower[i];
+                        upper[i] = x + y;
+                        lower[i] = x - y;
+                    }
+                }
+            }
+        }
+    }
+
+    // --- and write the sub-block back
+    const float* feedbackOutput[N * Lanes];
+    for (int index = 0; index < N * Lanes; index++)
+    {
+        for (int i = 0; i < numSamples; i++)
+        {
+            mFeedbackOutput[index][i] = (float)mMatrix[index][i];
+        }
+        feedbackOutput[index] = mFeedbackOutput[index];
+    }
+    mDelayLines.writeBlock(feedbackOutput, numSamples);
+
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        for (int i = 0; i < numSamples; i++)
+        {
+            output[lane][i] = mMatrix[slot(0, lane)][i] * mOutputGain;
+        }
+    }
+}
+
+#endif /* FeedbackDelayNetwork_h */
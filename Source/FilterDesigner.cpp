@@ -10,12 +10,25 @@
 
 void FilterDesigner::setParameter(float cut_off, float sample_rate, float Q, float slope, float magnitude)
 {
+	if (designed && model == last_model && cut_off == last_cut_off && sample_rate == last_sample_rate
+		&& Q == last_q && slope == last_slope && magnitude == last_magnitude)
+	{
+		return;
+	}
+	designed = true;
+	last_model = model;
+	last_cut_off = cut_off;
+	last_sample_rate = sample_rate;
+	last_q = Q;
+	last_slope = slope;
+	last_magnitude = magnitude;
+
 	omega = TWO_PI * cut_off / sample_rate;
 	sine_omega = sin(omega);
 	cosine_omega = cos(omega);
 	gain = pow(10, (magnitude / 20));
 	q = Q;
-	slope = slope;
+	this->slope = slope;
 	setCoefficients();
 }
 
@@ -125,8 +138,13 @@ void FilterDesigner::setCoefficients()
 		b0 = 1;
 		break;
 	case E_PEAK:
+		alpha = sine_omega / (2 * q);
+		setPeakCoefficients(sqrt(gain));
 		break;
 	case E_PARAMETRIC:
+		// bandwidth in octaves between the half-gain points
+		alpha = sine_omega * sinh(log(2.0) / 2 * q * omega / sine_omega);
+		setPeakCoefficients(sqrt(gain));
 		break;
 	case E_BAND_PASS:
 		alpha = sine_omega / (2 * q);
@@ -145,25 +163,85 @@ void FilterDesigner::setCoefficients()
 		b0 = 1;
 		break;
 	case E_BAND_REJECT:
+		alpha = sine_omega / (2 * q);
+
+		// denominator normalization
+		b0 = 1 + alpha;
+		b1 = (-2 * cosine_omega) / b0;
+		b2 = (1 - alpha) / b0;
+
+		// numerator normalization
+		a0 = gain / b0;
+		a1 = (-2 * cosine_omega) * gain / b0;
+		a2 = gain / b0;
+
+		// set b0 into 1 after coefficients normalization 
+		b0 = 1;
 		break;
 	case E_LOW_SHELF:
+		setShelfCoefficients(sqrt(gain), 1);
 		break;
 	case E_HIGH_SHELF:
+		setShelfCoefficients(sqrt(gain), -1);
 		break;
 	}
 }
 
-float* FilterDesigner::getCoefficients()
+void FilterDesigner::setPeakCoefficients(float amplitude)
+{
+	// denominator normalization
+	b0 = 1 + alpha / amplitude;
+	b1 = (-2 * cosine_omega) / b0;
+	b2 = (1 - alpha / amplitude) / b0;
+
+	// numerator normalization
+	a0 = (1 + alpha * amplitude) / b0;
+	a1 = (-2 * cosine_omega) / b0;
+	a2 = (1 - alpha * amplitude) / b0;
+
+	// set b0 into 1 after coefficients normalization 
+	b0 = 1;
+}
+
+void FilterDesigner::setShelfCoefficients(float amplitude, float side)
+{
+	// side is 1 for a low shelf and -1 for a high shelf, which mirrors the cosine terms
+	float cosine = side * cosine_omega;
+	if (slope > 0)
+	{
+		alpha = sine_omega / 2 * sqrt((amplitude + 1 / amplitude) * (1 / slope - 1) + 2);
+	}
+	else
+	{
+		alpha = sine_omega / (2 * q);
+	}
+	float beta = 2 * sqrt(amplitude) * alpha;
+
+	// denominator normalization
+	b0 = (amplitude + 1) + (amplitude - 1) * cosine + beta;
+	b1 = -2 * side * ((amplitude - 1) + (amplitude + 1) * cosine) / b0;
+	b2 = ((amplitude + 1) + (amplitude - 1) * cosine - beta) / b0;
+
+	// numerator normalization
+	a0 = amplitude * ((amplitude + 1) - (amplitude - 1) * cosine + beta) / b0;
+	a1 = 2 * side * amplitude * ((amplitude - 1) - (amplitude + 1) * cosine) / b0;
+	a2 = amplitude * ((amplitude + 1) - (amplitude - 1) * cosine - beta) / b0;
+
+	// set b0 into 1 after coefficients normalization 
+	b0 = 1;
+}
+
+FilterCoefficients FilterDesigner::getCoefficients() const
 {
-	static float coefficients[6];
+	FilterCoefficients coefficients;
 	// numerator of transfer function
-	coefficients[0] = a0;
-	coefficients[1] = a1;
-	coefficients[2] = a2;
+	coefficients.coefficients[0] = a0;
+	coefficients.coefficients[1] = a1;
+	coefficients.coefficients[2] = a2;
 
 	// denominator of transfer function
-	coefficients[3] = b0;
-	coefficients[4] = b1;
-	coefficients[5] = b2;
+	coefficients.coefficients[3] = b0;
+	coefficients.coefficients[4] = b1;
+	coefficients.coefficients[5] = b2;
 	return coefficients;
 }
\ No newline at end of file
@@ -11,6 +11,10 @@
 
 #include <math.h>
 
+#ifndef TWO_PI
+#define TWO_PI 6.283185307179586476925286766559
+#endif
+
 enum E_FILTER_TYPE
 {
 	E_FLAT		  = 0,
@@ -28,6 +32,20 @@ enum E_FILTER_TYPE
 	E_HIGH_SHELF  = 12,
 };
 
+// numerator a0, a1, a2, then denominator b0, b1, b2 of the transfer function, by value so
+// every caller owns its copy
+struct FilterCoefficients
+{
+	float coefficients[6];
+
+	float operator[](int index) const
+	{
+		return coefficients[index];
+	}
+};
+
+// setParameter() only redesigns the filter when one of its inputs or the model changed since
+// the last call, so calling it every block with steady parameters costs a few comparisons.
 class FilterDesigner
 {
 
@@ -41,13 +59,18 @@ public:
     {
     };
 
+	// magnitude in dB is the boost or cut of peaks and shelves and the output gain of the other
+	// models, Q is a bandwidth in octaves for E_PARAMETRIC, and a slope above 0 replaces Q for shelves
 	void setParameter(float cut_off = 1200, float sample_rate = 44100, float Q = 0.707, float slope = 0, float magnitude = 0);
     void setCoefficients();
-	float* getCoefficients();
+	FilterCoefficients getCoefficients() const;
 	int model;
 
 private:
-	double TWO_PI = 6.283185307179586476925286766559;
+	// amplitude is the square root of the linear gain
+	void setPeakCoefficients(float amplitude);
+	void setShelfCoefficients(float amplitude, float side);
+
 	double EULER = 2.71828182845904523536;
 
 	// numerator of transfer function
@@ -66,6 +89,15 @@ private:
 	float q;
 	float slope;
 	float alpha;
+
+	// inputs of the last design
+	bool designed = false;
+	int last_model = E_FLAT;
+	float last_cut_off = 0;
+	float last_sample_rate = 0;
+	float last_q = 0;
+	float last_slope = 0;
+	float last_magnitude = 0;
 };
 
 #endif /* FilterDesigner_h */
\ No newline at end of file
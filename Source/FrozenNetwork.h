@@ -0,0 +1,254 @@
+//
+//  FrozenNetwork.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef FrozenNetwork_h
+#define FrozenNetwork_h
+
+#include "PartitionedConvolver.h"
+#include <atomic>
+
+// With no modulation and controls that stand still a feedback network is a linear,
+// time-invariant filter, so it can run as the convolution with its own impulse response. This
+// watches the controls of one network and switches it between the two:
+//  - E_LIVE: the network runs. Once its controls have held for the hold time, they are handed
+//    to a background thread, which renders the impulse response and sets it
+//  - E_FREEZING: when the response is ready and the controls have not moved since, the input
+//    goes to the convolver only, and the network rings out on silence for the response length
+//  - E_FROZEN: the convolver runs alone, the network is not run at all
+//  - E_THAWING: as soon as a control moves, the input goes back to the network, and the
+//    convolver rings out on silence for the response length
+// Both halves run side by side on their part of the signal while switching, and their outputs
+// add up, so there is no fade and no gap. Freezing gives what the network alone would give, up
+// to the part of the response below the noise floor where it is cut. Thawing lets the tail of
+// what was played while frozen end on the frozen controls, only new input hears the change.
+//
+// Controls are compared with operator==. A response that does not decay within the prepared
+// length is reported with a length of 0, and those controls are not requested again.
+template <typename Controls, int Lanes>
+class FrozenNetwork
+{
+
+public:
+    enum E_FREEZE_STATE
+    {
+        E_LIVE,
+        E_FREEZING,
+        E_FROZEN,
+        E_THAWING
+    };
+
+    FrozenNetwork()
+    {
+        mHoldTime = 0;
+        mState = E_LIVE;
+        mInvariant = false;
+        mStill = 0;
+        mRemaining = 0;
+        mResponseLength = 0;
+        mHasFailed = false;
+    };
+
+    ~FrozenNetwork()
+    {
+    };
+
+    // --- responses of up to maxLength samples, controls have to hold for holdTime samples;
+    // --- not while the background thread runs
+    void prepare(int maxLength, int holdTime);
+    // --- back to E_LIVE, the convolver stops
+    void reset();
+
+    // --- audio thread, once per block before process(): the controls the network runs with
+    // --- for the next numSamples samples, and whether they make it time-invariant
+    void update(const Controls& controls, bool timeInvariant, int numSamples);
+    int getState() const;
+    // --- whether the network runs in this block, and whether it gets the input
+    bool runsNetwork() const;
+    bool feedsNetwork() const;
+    // --- adds the convolver's part of this block to output
+    void process(const float* const* input, float* const* output, int numSamples);
+
+    // --- background thread: whether controls wait for their response, which controls, and
+    // --- their response, length 0 when it did not decay in time
+    bool isRequested() const;
+    const Controls& getRequest() const;
+    void setImpulseResponse(const float* response, int length);
+
+private:
+    enum
+    {
+        kIdle,
+        kRequested,
+        kDone
+    };
+
+    // --- the handshake: the audio thread writes mRequest before kRequested, the background
+    // --- thread writes the kernel and mResponseLength before kDone, and only kDone goes back to kIdle
+    std::atomic<int> mSlot { kIdle };
+    Controls mRequest;
+    int mResponseLength;
+    ConvolutionKernel mKernel;
+    PartitionedConvolver<Lanes> mConvolver;
+
+    int mHoldTime;
+    int mState;
+    Controls mControls;
+    bool mInvariant;
+    // --- samples the controls have held, and samples left to ring out
+    int mStill;
+    int mRemaining;
+    Controls mFailed;
+    bool mHasFailed;
+};
+
+template <typename Controls, int Lanes>
+void FrozenNetwork<Controls, Lanes>::prepare(int maxLength, int holdTime)
+{
+    mKernel.prepare(maxLength);
+    mConvolver.prepare(maxLength);
+    mHoldTime = holdTime;
+    mSlot = kIdle;
+    mHasFailed = false;
+    reset();
+}
+
+template <typename Controls, int Lanes>
+void FrozenNetwork<Controls, Lanes>::reset()
+{
+    mConvolver.start(nullptr);
+    mState = E_LIVE;
+    mInvariant = false;
+    mStill = 0;
+    mRemaining = 0;
+}
+
+template <typename Controls, int Lanes>
+void FrozenNetwork<Controls, Lanes>::update(const Controls& controls, bool timeInvariant, int numSamples)
+{
+    auto still = timeInvariant && mInvariant && controls == mControls;
+    mControls = controls;
+    mInvariant = timeInvariant;
+    mStill = still ? juce::jmin(mStill + numSamples, mHoldTime) : 0;
+
+    switch (mState)
+    {
+        case E_LIVE:
+        {
+            auto slot = mSlot.load(std::memory_order_acquire);
+            if (slot == kDone)
+            {
+                if (mResponseLength == 0)
+                {
+                    mFailed = mRequest;
+                    mHasFailed = true;
+                }
+                else if (still && mRequest == mControls)
+                {
+                    mConvolver.start(&mKernel);
+                    mState = E_FREEZING;
+                    mRemaining = mResponseLength;
+                }
+                mSlot.store(kIdle, std::memory_order_release);
+            }
+            else if (slot == kIdle && still && mStill >= mHoldTime && !(mHasFailed && mFailed == mControls))
+            {
+                mRequest = mControls;
+                mSlot.store(kRequested, std::memory_order_release);
+            }
+            break;
+        }
+        case E_FREEZING:
+            if (!still)
+            {
+                mState = E_THAWING;
+                mRemaining = mResponseLength;
+            }
+            else if (mRemaining <= 0)
+            {
+                mState = E_FROZEN;
+            }
+            break;
+        case E_FROZEN:
+            if (!still)
+            {
+                mState = E_THAWING;
+                mRemaining = mResponseLength;
+            }
+            break;
+        case E_THAWING:
+            if (mRemaining <= 0)
+            {
+                mConvolver.start(nullptr);
+                mState = E_LIVE;
+            }
+            break;
+    }
+
+    // --- counts the samples run in a switching state, this block included
+    if (mState == E_FREEZING || mState == E_THAWING)
+    {
+        mRemaining -= numSamples;
+    }
+}
+
+template <typename Controls, int Lanes>
+int FrozenNetwork<Controls, Lanes>::getState() const
+{
+    return mState;
+}
+
+template <typename Controls, int Lanes>
+bool FrozenNetwork<Controls, Lanes>::runsNetwork() const
+{
+    return mState != E_FROZEN;
+}
+
+template <typename Controls, int Lanes>
+bool FrozenNetwork<Controls, Lanes>::feedsNetwork() const
+{
+    return mState == E_LIVE || mState == E_THAWING;
+}
+
+template <typename Controls, int Lanes>
+void FrozenNetwork<Controls, Lanes>::process(const float* const* input, float* const* output, int numSamples)
+{
+    if (mState == E_FREEZING || mState == E_FROZEN)
+    {
+        mConvolver.process(input, output, numSamples);
+    }
+    else if (mState == E_THAWING)
+    {
+        mConvolver.process(nullptr, output, numSamples);
+    }
+}
+
+template <typename Controls, int Lanes>
+bool FrozenNetwork<Controls, Lanes>::isRequested() const
+{
+    return mSlot.load(std::memory_order_acquire) == kRequested;
+}
+
+template <typename Controls, int Lanes>
+const Controls& FrozenNetwork<Controls, Lanes>::getRequest() const
+{
+    return mRequest;
+}
+
+template <typename Controls, int Lanes>
+void FrozenNetwork<Controls, Lanes>::setImpulseResponse(const float* response, int length)
+{
+    // --- the convolver only runs on the kernel outside E_LIVE, and no request is made then
+    if (length > 0)
+    {
+        mKernel.setImpulseResponse(response, length);
+    }
+    mResponseLength = length > 0 ? mKernel.getLength() : 0;
+    mSlot.store(kDone, std::memory_order_release);
+}
+
+#endif /* FrozenNetwork_h */
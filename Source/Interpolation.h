@@ -0,0 +1,110 @@
+//
+//  Interpolation.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef Interpolation_h
+#define Interpolation_h
+
+// Interpolation policies for the fractional delay reads of CircularBuffer and MultiLineDelay.
+// The delay line hands every policy the same 4-sample neighbourhood of the read position:
+// taps[0], taps[stride], taps[2 * stride], taps[3 * stride] hold x2, x1, x0, xm1, which are
+// the samples at delay index + 2, index + 1, index and index - 1, and frac_pos is the part of
+// the delay behind the decimal point. Policies are objects, so a stateful kernel keeps its
+// state per tap, and the delay line gets the kernel inlined without any runtime switch.
+
+struct NoInterpolation
+{
+    void reset() {}
+
+    template <typename T>
+    float interpolate(const T* taps, int stride, float frac_pos)
+    {
+        return taps[2 * stride];
+    }
+};
+
+struct LinearInterpolation
+{
+    void reset() {}
+
+    template <typename T>
+    float interpolate(const T* taps, int stride, float frac_pos)
+    {
+        float y1 = taps[2 * stride];
+        float y2 = taps[stride];
+        return frac_pos * y2 + (1 - frac_pos) * y1;
+    }
+};
+
+struct HermiteInterpolation
+{
+    void reset() {}
+
+    template <typename T>
+    float interpolate(const T* taps, int stride, float frac_pos)
+    {
+        float x2 = taps[0];
+        float x1 = taps[stride];
+        float x0 = taps[2 * stride];
+        float xm1 = taps[3 * stride];
+
+        const float c = (x1 - xm1) * 0.5f;
+        const float v = x0 - x1;
+        const float w = c + v;
+        const float a = w + v + (x2 - x0) * 0.5f;
+        const float b_neg = w + a;
+        return ((((a * frac_pos) - b_neg) * frac_pos + c) * frac_pos + x0);
+    }
+};
+
+// third order lagrange through xm1..x2, evaluated in farrow form: the polynomial coefficients
+// depend on the samples only, so there is no division and no nested loop per read
+struct LagrangeInterpolation
+{
+    void reset() {}
+
+    template <typename T>
+    float interpolate(const T* taps, int stride, float frac_pos)
+    {
+        float x2 = taps[0];
+        float x1 = taps[stride];
+        float x0 = taps[2 * stride];
+        float xm1 = taps[3 * stride];
+
+        const float c0 = x0;
+        const float c1 = x1 - xm1 * (1.0f / 3.0f) - x0 * 0.5f - x2 * (1.0f / 6.0f);
+        const float c2 = (xm1 + x1) * 0.5f - x0;
+        const float c3 = (x2 - xm1) * (1.0f / 6.0f) + (x0 - x1) * 0.5f;
+        return ((c3 * frac_pos + c2) * frac_pos + c1) * frac_pos + c0;
+    }
+};
+
+// first order thiran allpass, flat magnitude response for the price of one state variable.
+// the allpass realises a delay of 1 + frac_pos between xm1 and x0, which keeps its
+// coefficient inside (-1/3, 0] and the group delay well behaved.
+struct ThiranInterpolation
+{
+    void reset()
+    {
+        z1 = 0;
+    }
+
+    template <typename T>
+    float interpolate(const T* taps, int stride, float frac_pos)
+    {
+        float x0 = taps[2 * stride];
+        float xm1 = taps[3 * stride];
+
+        const float eta = -frac_pos / (2.0f + frac_pos);
+        z1 = eta * xm1 + x0 - eta * z1;
+        return z1;
+    }
+
+    float z1 = 0;
+};
+
+#endif /* Interpolation_h */
@@ -0,0 +1,129 @@
+//
+//  LfoBank.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef LfoBank_h
+#define LfoBank_h
+
+#include <math.h>
+#include "Oscillator.h"
+
+// N sine LFOs at one frequency, output k shifted by k / N of a period, so for N = 4 the
+// same 0, pi/2, pi and 3pi/2 as four Oscillator objects with those offsets. Instead of N
+// sin() calls per step the bank rotates one complex phasor (cos, sin) and takes every output
+// as a fixed linear combination of it: sin(x + offset) = sin(x) cos(offset) + cos(x) sin(offset).
+//
+// The phase is kept wrapped to [0, 2 pi), so it does not lose precision over long sessions,
+// and every kResyncInterval steps the phasor is set back onto it, which cancels the slow
+// drift of the rotation in both magnitude and angle.
+template <int N>
+class LfoBank
+{
+
+public:
+    LfoBank()
+    {
+        for (int index = 0; index < N; index++)
+        {
+            double offset = (double)index / N * TWO_PI;
+            mOffsetCos[index] = cos(offset);
+            mOffsetSin[index] = sin(offset);
+        }
+        mFrequency = 0;
+        mSampleRate = 0;
+        mIncrement = 0;
+        mRotationCos = 1;
+        mRotationSin = 0;
+        reset();
+    };
+
+    ~LfoBank()
+    {
+    };
+
+    void reset();
+    // --- sampleRate is the rate process() is called at
+    void setFrequency(double frequency, double sampleRate);
+    // --- writes the N outputs of the current step, then advances one step
+    void process(double* output);
+
+    static const int kResyncInterval = 1024;
+
+private:
+    void resync();
+
+    double mPhase;
+    double mCos;
+    double mSin;
+    int mStepsSinceResync;
+
+    double mFrequency;
+    double mSampleRate;
+    double mIncrement;
+    double mRotationCos;
+    double mRotationSin;
+
+    double mOffsetCos[N];
+    double mOffsetSin[N];
+};
+
+template <int N>
+void LfoBank<N>::reset()
+{
+    mPhase = 0;
+    resync();
+}
+
+template <int N>
+void LfoBank<N>::setFrequency(double frequency, double sampleRate)
+{
+    if (frequency == mFrequency && sampleRate == mSampleRate)
+    {
+        return;
+    }
+    mFrequency = frequency;
+    mSampleRate = sampleRate;
+    mIncrement = TWO_PI * frequency / sampleRate;
+    mRotationCos = cos(mIncrement);
+    mRotationSin = sin(mIncrement);
+}
+
+template <int N>
+inline void LfoBank<N>::process(double* output)
+{
+    for (int index = 0; index < N; index++)
+    {
+        output[index] = mSin * mOffsetCos[index] + mCos * mOffsetSin[index];
+    }
+
+    // --- rotate the phasor and keep the wrapped phase alongside
+    double nextCos = mCos * mRotationCos - mSin * mRotationSin;
+    double nextSin = mSin * mRotationCos + mCos * mRotationSin;
+    mCos = nextCos;
+    mSin = nextSin;
+
+    mPhase += mIncrement;
+    if (mPhase >= TWO_PI)
+    {
+        mPhase -= TWO_PI;
+    }
+
+    if (++mStepsSinceResync == kResyncInterval)
+    {
+        resync();
+    }
+}
+
+template <int N>
+void LfoBank<N>::resync()
+{
+    mCos = cos(mPhase);
+    mSin = sin(mPhase);
+    mStepsSinceResync = 0;
+}
+
+#endif /* LfoBank_h */
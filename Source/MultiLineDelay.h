@@ -0,0 +1,215 @@
+//
+//  MultiLineDelay.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef MultiLineDelay_h
+#define MultiLineDelay_h
+
+#include <algorithm>
+#include <memory>
+#include <math.h>
+#include "Interpolation.h"
+#include "SampleStorage.h"
+
+// N delay lines sharing one write position, stored interleaved: frame k holds sample k of
+// every line next to each other, so the N writes of one sample are a single contiguous
+// store and the N taps of one read land in neighbouring frames instead of N separate buffers.
+// Interpolator picks the kernel of the fractional reads at compile time, see Interpolation.h,
+// and Storage is the sample format kept in memory, see SampleStorage.h.
+template <typename T, int N, typename Interpolator = HermiteInterpolation, typename Storage = T>
+class MultiLineDelay
+{
+
+public:
+    MultiLineDelay()
+    {
+        mWriteIndex = 0;
+        mBufferLength = 0;
+        mWrapMask = 0;
+    };
+
+    ~MultiLineDelay()
+    {
+    };
+
+    void createMultiLineDelay(unsigned int input);
+    void createMultiLineDelay(unsigned int input, Storage* memory);
+    static unsigned int getRequiredLength(unsigned int input);
+    void flushBuffer();
+    void writeFrame(const T* input);
+
+    T readBuffer(int line, int delayInSamples);
+    void readFrame(T* output, const int* delayInSamples);
+    void readFrame(T* output, const float* delayInFractionalSamples);
+
+    // --- block access, with the same rules as the block methods of CircularBuffer
+    void writeBlock(const T* const* input, int numSamples);
+    void readBlock(int line, T* output, const float* delayInFractionalSamples, int numSamples);
+    // --- lines line .. line + numLines - 1 tapped at the same positions, the offsets are
+    // --- resolved once and the taps of neighbouring lines share their cache lines
+    void readBlock(int line, int numLines, T* const* output, const float* delayInFractionalSamples, int numSamples);
+
+    // --- the first frames are mirrored past the end, so a 4-point kernel never wraps
+    static const int kGuardFrames = 4;
+
+private:
+    // --- mBuffer either points into mOwnedBuffer or into memory handed in from outside
+    std::unique_ptr<Storage[]> mOwnedBuffer = nullptr;
+    Storage* mBuffer = nullptr;
+    unsigned int mWriteIndex;
+    unsigned int mBufferLength;
+    unsigned int mWrapMask;
+    // --- one kernel per line, so stateful kernels keep their own history
+    Interpolator mInterpolator[N];
+    SampleEncoder<Storage> mEncoder;
+};
+
+template <typename T, int N, typename Interpolator, typename Storage>
+unsigned int MultiLineDelay<T, N, Interpolator, Storage>::getRequiredLength(unsigned int input)
+{
+    // --- one frame of N samples per position, power of 2 frames plus the mirrored guard frames
+    return ((unsigned int)(pow(2, ceil(logf(input) / logf(2)))) + kGuardFrames) * N;
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::createMultiLineDelay(unsigned int input)
+{
+    mOwnedBuffer.reset(new Storage[getRequiredLength(input)]);
+    createMultiLineDelay(input, mOwnedBuffer.get());
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::createMultiLineDelay(unsigned int input, Storage* memory)
+{
+    // --- memory has to hold getRequiredLength(input) samples and outlive the delay
+    if (memory != mOwnedBuffer.get())
+    {
+        mOwnedBuffer.reset();
+    }
+    mBuffer = memory;
+    // --- reset the to top
+    mWriteIndex = 0;
+    // --- init buffer length (in frames) as power of 2
+    mBufferLength = getRequiredLength(input) / N - kGuardFrames;
+    // --- warp mask as (mBufferLength - 1) for binary &= calculation
+    mWrapMask = mBufferLength - 1;
+    // --- clean the value inside mBuffer
+    flushBuffer();
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::flushBuffer()
+{
+    std::fill(mBuffer, mBuffer + (mBufferLength + kGuardFrames) * N, Storage());
+    mEncoder.reset();
+    for (int line = 0; line < N; line++)
+    {
+        mInterpolator[line].reset();
+    }
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::writeFrame(const T* input)
+{
+    Storage* frame = mBuffer + mWriteIndex * N;
+    for (int line = 0; line < N; line++)
+    {
+        frame[line] = mEncoder.encode(input[line]);
+    }
+    // --- keep the mirror of the first frames in step
+    if (mWriteIndex < kGuardFrames)
+    {
+        Storage* guard = frame + mBufferLength * N;
+        for (int line = 0; line < N; line++)
+        {
+            guard[line] = frame[line];
+        }
+    }
+    mWriteIndex = (mWriteIndex + 1) & mWrapMask;
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+T MultiLineDelay<T, N, Interpolator, Storage>::readBuffer(int line, int delayInSamples)
+{
+    return (T)mBuffer[((mWriteIndex - delayInSamples) & mWrapMask) * N + line];
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::readFrame(T* output, const int* delayInSamples)
+{
+    for (int line = 0; line < N; line++)
+    {
+        output[line] = (T)mBuffer[((mWriteIndex - delayInSamples[line]) & mWrapMask) * N + line];
+    }
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::readFrame(T* output, const float* delayInFractionalSamples)
+{
+    // --- resolve the N tap positions first, the kernels below then read a plain strided gather
+    unsigned int offset[N];
+    float frac_pos[N];
+    for (int line = 0; line < N; line++)
+    {
+        int index = (int)delayInFractionalSamples[line];
+        offset[line] = ((mWriteIndex - index - 2) & mWrapMask) * N + line;
+        frac_pos[line] = delayInFractionalSamples[line] - index;
+    }
+
+    // --- x2, x1, x0, xm1 of each line lie in consecutive frames from offset on
+    for (int line = 0; line < N; line++)
+    {
+        output[line] = mInterpolator[line].interpolate(mBuffer + offset[line], N, frac_pos[line]);
+    }
+}
+
+// --- sample i of a block read is taken i samples after the current write position, as if the
+// --- first i frames of the block had already been written. Read a block before writing it,
+// --- and keep every tap longer than the block, otherwise it touches frames not written yet.
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::writeBlock(const T* const* input, int numSamples)
+{
+    for (int i = 0; i < numSamples; i++)
+    {
+        Storage* frame = mBuffer + ((mWriteIndex + i) & mWrapMask) * N;
+        for (int line = 0; line < N; line++)
+        {
+            frame[line] = mEncoder.encode(input[line][i]);
+        }
+    }
+    mWriteIndex = (mWriteIndex + numSamples) & mWrapMask;
+    // --- refresh the mirror of the first frames
+    std::copy(mBuffer, mBuffer + kGuardFrames * N, mBuffer + mBufferLength * N);
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::readBlock(int line, T* output, const float* delayInFractionalSamples, int numSamples)
+{
+    for (int i = 0; i < numSamples; i++)
+    {
+        int index = (int)delayInFractionalSamples[i];
+        unsigned int offset = ((mWriteIndex + i - index - 2) & mWrapMask) * N + line;
+        output[i] = mInterpolator[line].interpolate(mBuffer + offset, N, delayInFractionalSamples[i] - index);
+    }
+}
+
+template <typename T, int N, typename Interpolator, typename Storage>
+void MultiLineDelay<T, N, Interpolator, Storage>::readBlock(int line, int numLines, T* const* output, const float* delayInFractionalSamples, int numSamples)
+{
+    for (int i = 0; i < numSamples; i++)
+    {
+        int index = (int)delayInFractionalSamples[i];
+        float frac_pos = delayInFractionalSamples[i] - index;
+        unsigned int offset = ((mWriteIndex + i - index - 2) & mWrapMask) * N + line;
+        for (int next = 0; next < numLines; next++)
+        {
+            output[next][i] = mInterpolator[line + next].interpolate(mBuffer + offset + next, N, frac_pos);
+        }
+    }
+}
+
+#endif /* MultiLineDelay_h */
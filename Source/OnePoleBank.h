@@ -0,0 +1,122 @@
+//
+//  OnePoleBank.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef OnePoleBank_h
+#define OnePoleBank_h
+
+#include <math.h>
+
+// Size first-order low-pass filters, y[n] = gain * x[n] + pole * y[n - 1], with their state and
+// coefficients held structure-of-arrays, one array per quantity. A step of the bank is one
+// loop over the filters with no dependency between them, so the compiler turns it into a few
+// SIMD instructions, and processBlock() interleaves the Size recursions instead of waiting on
+// one at a time.
+//
+// The coefficients are plain values set from the thread that processes, no lock is taken.
+// The arithmetic matches juce::IIRFilter::processSingleSampleRaw() with a one-pole design,
+// including its snap of tiny outputs to zero, so the output is the same to the bit.
+template <int Size>
+class OnePoleBank
+{
+
+public:
+    OnePoleBank()
+    {
+        setCoefficients(1, 0);
+        reset();
+    };
+
+    ~OnePoleBank()
+    {
+    };
+
+    void reset();
+    // --- all filters at once, or filter index alone
+    void setCoefficients(float gain, float pole);
+    void setCoefficients(int index, float gain, float pole);
+
+    // --- one step of every filter, input and output hold one value per filter
+    void processFrame(const float* input, float* output);
+    // --- numSamples steps of every filter, one row per filter
+    void processBlock(const float* const* input, float* const* output, int numSamples);
+
+private:
+    static float snapToZero(float value)
+    {
+        return fabsf(value) > 1.0e-8f ? value : 0.0f;
+    }
+
+    float mGain[Size];
+    float mPole[Size];
+    // --- pole * y[n - 1] of every filter
+    float mState[Size];
+};
+
+template <int Size>
+void OnePoleBank<Size>::reset()
+{
+    for (int index = 0; index < Size; index++)
+    {
+        mState[index] = 0;
+    }
+}
+
+template <int Size>
+void OnePoleBank<Size>::setCoefficients(float gain, float pole)
+{
+    for (int index = 0; index < Size; index++)
+    {
+        setCoefficients(index, gain, pole);
+    }
+}
+
+template <int Size>
+void OnePoleBank<Size>::setCoefficients(int index, float gain, float pole)
+{
+    mGain[index] = gain;
+    mPole[index] = pole;
+}
+
+template <int Size>
+inline void OnePoleBank<Size>::processFrame(const float* input, float* output)
+{
+    for (int index = 0; index < Size; index++)
+    {
+        auto y = snapToZero(mGain[index] * input[index] + mState[index]);
+        mState[index] = mPole[index] * y;
+        output[index] = y;
+    }
+}
+
+template <int Size>
+inline void OnePoleBank<Size>::processBlock(const float* const* input, float* const* output, int numSamples)
+{
+    // --- the state stays in a local copy, so it can live in registers across the block
+    float state[Size];
+    for (int index = 0; index < Size; index++)
+    {
+        state[index] = mState[index];
+    }
+
+    for (int i = 0; i < numSamples; i++)
+    {
+        for (int index = 0; index < Size; index++)
+        {
+            auto y = snapToZero(mGain[index] * input[index][i] + state[index]);
+            state[index] = mPole[index] * y;
+            output[index][i] = y;
+        }
+    }
+
+    for (int index = 0; index < Size; index++)
+    {
+        mState[index] = state[index];
+    }
+}
+
+#endif /* OnePoleBank_h */
@@ -37,6 +37,8 @@ float ParameterSmooth::process(float input)
 
     if (fabsf(z0 - z1) < b * 0.001)
     {
+        // settled, park the state on the target so every further call is a no-op
+        z0 = input;
         return input;
     }
     else
@@ -45,6 +47,30 @@ float ParameterSmooth::process(float input)
     }
 }
 
+void ParameterSmooth::processBlock(float input, float* output, int numSamples)
+{
+    int i = 0;
+    for (; i < numSamples && !isSettled(input); i++)
+    {
+        output[i] = process(input);
+    }
+    for (; i < numSamples; i++)
+    {
+        output[i] = input;
+    }
+}
+
+bool ParameterSmooth::isSettled(float input)
+{
+    return z0 == input;
+}
+
+void ParameterSmooth::reset()
+{
+    z0 = 0.0f;
+    z1 = 0.0f;
+}
+
 void ParameterSmooth::setSampleRate(float input)
 {
     mSampleRate = input;
@@ -34,6 +34,12 @@ public:
     void setSampleRate(float input);
     void setSmoothingTimeInMs(float input);
     float process(float input);
+    // --- numSamples values of process(input), the settled part as one fill
+    void processBlock(float input, float* output, int numSamples);
+    // --- true when process(input) returns input and leaves the state as it is, until the target moves
+    bool isSettled(float input);
+    // --- back to the state right after createCoefficients(), the coefficients are kept
+    void reset();
     
 private:
     float c_twoPi = 6.283185307179586476925286766559f;
@@ -0,0 +1,369 @@
+//
+//  PartitionedConvolver.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef PartitionedConvolver_h
+#define PartitionedConvolver_h
+
+#include <JuceHeader.h>
+#include <vector>
+
+// An impulse response cut into the pieces a PartitionedConvolver runs on, and their spectra:
+//  - the first kHeadSize taps, applied directly
+//  - the taps up to kTailSize, in partitions of kHeadSize, transformed with FFTs of 2 * kHeadSize
+//  - the rest, in partitions of kTailSize, transformed with FFTs of 2 * kTailSize
+// Transforming a response takes a while, so it is done off the audio thread, into a kernel no
+// convolver runs on at the time. One kernel serves any number of convolvers.
+class ConvolutionKernel
+{
+
+public:
+    ConvolutionKernel()
+        : mShortFFT(kShortOrder), mLongFFT(kLongOrder)
+    {
+        mMaxLength = 0;
+        mLength = 0;
+        mNumShortPartitions = 0;
+        mNumLongPartitions = 0;
+    };
+
+    ~ConvolutionKernel()
+    {
+    };
+
+    static const int kHeadSize = 64;
+    static const int kTailSize = 1024;
+    static const int kShortOrder = 7;
+    static const int kLongOrder = 11;
+    static const int kMaxShortPartitions = kTailSize / kHeadSize - 1;
+
+    // --- partitions of kTailSize after the first one, for a response of length samples
+    static int getNumLongPartitions(int length);
+
+    // --- memory for responses of up to maxLength samples
+    void prepare(int maxLength);
+    // --- longer responses are cut at the prepared length
+    void setImpulseResponse(const float* response, int length);
+    int getLength() const;
+
+private:
+    template <int Lanes>
+    friend class PartitionedConvolver;
+
+    // --- spectrum of taps start .. start + size - 1 of response, zero padded to 2 * size
+    void transform(const juce::dsp::FFT& fft, const float* response, int length, int start, int size, float* spectrum);
+
+    juce::dsp::FFT mShortFFT;
+    juce::dsp::FFT mLongFFT;
+    int mMaxLength;
+    int mLength;
+    // --- the head taps back to front, so the direct part is a dot product with the history
+    float mHead[kHeadSize];
+    int mNumShortPartitions;
+    int mNumLongPartitions;
+    // --- 2 * size + 2 interleaved values per spectrum, partition 1 first
+    std::vector<float> mShortSpectra;
+    std::vector<float> mLongSpectra;
+    std::vector<float> mScratch;
+};
+
+// Zero latency convolution of Lanes channels with one ConvolutionKernel, by non-uniform
+// partitioning. The head runs as a direct FIR, so the first output sample needs no FFT. Every
+// kHeadSize samples the last block goes through a short FFT into a frequency-domain delay line
+// and the next kHeadSize output samples of the short partitions come out of one inverse FFT.
+// The long partitions work the same way every kTailSize samples. Partition j of a stage only
+// reaches output that is at least j blocks later, which is what hides the latency of the block
+// transforms.
+//
+// The work per sample is the head FIR plus two FFT blocks spread over their sizes, and a
+// complex multiply-add per bin and partition. The delay lines are not cleared by start(),
+// partitions count in only once their block has run since.
+template <int Lanes>
+class PartitionedConvolver
+{
+
+public:
+    PartitionedConvolver()
+        : mShortStage(ConvolutionKernel::kShortOrder), mLongStage(ConvolutionKernel::kLongOrder)
+    {
+        mKernel = nullptr;
+        mPosition = 0;
+        mHistoryIndex = 0;
+    };
+
+    ~PartitionedConvolver()
+    {
+    };
+
+    // --- memory for kernels of up to maxLength samples, not on the audio thread
+    void prepare(int maxLength);
+    // --- starts over on kernel with silent history, nullptr stops
+    void start(const ConvolutionKernel* kernel);
+    bool isRunning() const;
+
+    // --- adds the convolution of input, one row per lane, to output; a nullptr input is silence
+    void process(const float* const* input, float* const* output, int numSamples);
+
+private:
+    struct Stage
+    {
+        Stage(int order)
+            : fft(order), size(1 << (order - 1))
+        {
+            capacity = 0;
+            newest = 0;
+            numValid = 0;
+        };
+
+        juce::dsp::FFT fft;
+        int size;
+        // --- spectra the delay line holds per lane, the newest at index newest
+        int capacity;
+        int newest;
+        int numValid;
+        // --- per lane the previous and the current block, then the output of the current block
+        std::vector<float> input;
+        std::vector<float> output;
+        std::vector<float> delayLine;
+        std::vector<float> scratch;
+    };
+
+    static void prepareStage(Stage& stage, int capacity);
+    static void clearStage(Stage& stage);
+    // --- at the end of a block, the output of the next block of the partitions
+    static void runStage(Stage& stage, const float* spectra, int numPartitions);
+
+    const ConvolutionKernel* mKernel;
+    Stage mShortStage;
+    Stage mLongStage;
+    // --- samples into the current long block
+    int mPosition;
+    // --- the last kHeadSize inputs of every lane, written twice so they read as one run
+    float mHistory[Lanes][2 * ConvolutionKernel::kHeadSize];
+    int mHistoryIndex;
+};
+
+inline int ConvolutionKernel::getNumLongPartitions(int length)
+{
+    return juce::jmax(0, (length + kTailSize - 1) / kTailSize - 1);
+}
+
+inline void ConvolutionKernel::prepare(int maxLength)
+{
+    mMaxLength = juce::jmax(0, maxLength);
+    mLength = 0;
+    mNumShortPartitions = 0;
+    mNumLongPartitions = 0;
+    mShortSpectra.assign(kMaxShortPartitions * (2 * kHeadSize + 2), 0.0f);
+    mLongSpectra.assign(getNumLongPartitions(mMaxLength) * (2 * kTailSize + 2), 0.0f);
+    mScratch.assign(4 * kTailSize, 0.0f);
+}
+
+inline void ConvolutionKernel::setImpulseResponse(const float* response, int length)
+{
+    mLength = juce::jlimit(0, mMaxLength, length);
+
+    for (int tap = 0; tap < kHeadSize; tap++)
+    {
+        mHead[kHeadSize - 1 - tap] = tap < mLength ? response[tap] : 0.0f;
+    }
+
+    mNumShortPartitions = juce::jlimit(0, kMaxShortPartitions, (mLength + kHeadSize - 1) / kHeadSize - 1);
+    for (int partition = 1; partition <= mNumShortPartitions; partition++)
+    {
+        transform(mShortFFT, response, mLength, partition * kHeadSize, kHeadSize, &mShortSpectra[(partition - 1) * (2 * kHeadSize + 2)]);
+    }
+
+    mNumLongPartitions = getNumLongPartitions(mLength);
+    for (int partition = 1; partition <= mNumLongPartitions; partition++)
+    {
+        transform(mLongFFT, response, mLength, partition * kTailSize, kTailSize, &mLongSpectra[(partition - 1) * (2 * kTailSize + 2)]);
+    }
+}
+
+inline int ConvolutionKernel::getLength() const
+{
+    return mLength;
+}
+
+inline void ConvolutionKernel::transform(const juce::dsp::FFT& fft, const float* response, int length, int start, int size, float* spectrum)
+{
+    std::fill(mScratch.begin(), mScratch.begin() + 4 * size, 0.0f);
+    auto end = juce::jmin(start + size, length);
+    if (end > start)
+    {
+        std::copy(response + start, response + end, mScratch.begin());
+    }
+    fft.performRealOnlyForwardTransform(mScratch.data(), true);
+    std::copy(mScratch.begin(), mScratch.begin() + 2 * size + 2, spectrum);
+}
+
+template <int Lanes>
+void PartitionedConvolver<Lanes>::prepare(int maxLength)
+{
+    prepareStage(mShortStage, ConvolutionKernel::kMaxShortPartitions);
+    prepareStage(mLongStage, ConvolutionKernel::getNumLongPartitions(maxLength));
+    start(nullptr);
+}
+
+template <int Lanes>
+void PartitionedConvolver<Lanes>::start(const ConvolutionKernel* kernel)
+{
+    mKernel = kernel;
+    mPosition = 0;
+    mHistoryIndex = 0;
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        std::fill(mHistory[lane], mHistory[lane] + 2 * ConvolutionKernel::kHeadSize, 0.0f);
+    }
+    clearStage(mShortStage);
+    clearStage(mLongStage);
+}
+
+template <int Lanes>
+bool PartitionedConvolver<Lanes>::isRunning() const
+{
+    return mKernel != nullptr;
+}
+
+template <int Lanes>
+void PartitionedConvolver<Lanes>::process(const float* const* input, float* const* output, int numSamples)
+{
+    if (mKernel == nullptr)
+    {
+        return;
+    }
+
+    const int headSize = ConvolutionKernel::kHeadSize;
+    const int tailSize = ConvolutionKernel::kTailSize;
+
+    // --- pieces that end on the next short block boundary at the latest
+    for (int start = 0; start < numSamples; )
+    {
+        auto shortPosition = mPosition % headSize;
+        auto length = juce::jmin(numSamples - start, headSize - shortPosition);
+
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            const float* x = input != nullptr ? input[lane] + start : nullptr;
+            float* y = output[lane] + start;
+            float* history = mHistory[lane];
+            float* shortInput = &mShortStage.input[(2 * lane + 1) * headSize + shortPosition];
+            float* longInput = &mLongStage.input[(2 * lane + 1) * tailSize + mPosition];
+            const float* shortOutput = &mShortStage.output[lane * headSize + shortPosition];
+            const float* longOutput = &mLongStage.output[lane * tailSize + mPosition];
+
+            auto index = mHistoryIndex;
+            for (int i = 0; i < length; i++)
+            {
+                auto sample = x != nullptr ? x[i] : 0.0f;
+                history[index] = sample;
+                history[index + headSize] = sample;
+                shortInput[i] = sample;
+                longInput[i] = sample;
+
+                // --- oldest to newest input at history[index + 1 .. index + headSize]
+                index = index + 1 == headSize ? 0 : index + 1;
+                const float* window = history + index;
+                float sum = 0;
+                for (int tap = 0; tap < headSize; tap++)
+                {
+                    sum += mKernel->mHead[tap] * window[tap];
+                }
+                y[i] += sum + shortOutput[i] + longOutput[i];
+            }
+        }
+
+        mHistoryIndex = (mHistoryIndex + length) % headSize;
+        mPosition += length;
+        start += length;
+
+        if (mPosition % headSize == 0)
+        {
+            runStage(mShortStage, mKernel->mShortSpectra.data(), mKernel->mNumShortPartitions);
+        }
+        if (mPosition == tailSize)
+        {
+            runStage(mLongStage, mKernel->mLongSpectra.data(), mKernel->mNumLongPartitions);
+            mPosition = 0;
+        }
+    }
+}
+
+template <int Lanes>
+void PartitionedConvolver<Lanes>::prepareStage(Stage& stage, int capacity)
+{
+    stage.capacity = capacity;
+    stage.input.assign(Lanes * 2 * stage.size, 0.0f);
+    stage.output.assign(Lanes * stage.size, 0.0f);
+    stage.delayLine.assign((size_t)Lanes * capacity * (2 * stage.size + 2), 0.0f);
+    stage.scratch.assign(4 * stage.size, 0.0f);
+}
+
+template <int Lanes>
+void PartitionedConvolver<Lanes>::clearStage(Stage& stage)
+{
+    std::fill(stage.input.begin(), stage.input.end(), 0.0f);
+    std::fill(stage.output.begin(), stage.output.end(), 0.0f);
+    stage.newest = 0;
+    stage.numValid = 0;
+}
+
+template <int Lanes>
+void PartitionedConvolver<Lanes>::runStage(Stage& stage, const float* spectra, int numPartitions)
+{
+    const int size = stage.size;
+    const int spectrumSize = 2 * size + 2;
+    float* scratch = stage.scratch.data();
+
+    numPartitions = juce::jmin(numPartitions, stage.capacity);
+    if (numPartitions == 0)
+    {
+        for (int lane = 0; lane < Lanes; lane++)
+        {
+            float* input = &stage.input[2 * lane * size];
+            std::copy(input + size, input + 2 * size, input);
+        }
+        return;
+    }
+
+    stage.newest = stage.newest + 1 == stage.capacity ? 0 : stage.newest + 1;
+    stage.numValid = juce::jmin(stage.numValid + 1, stage.capacity);
+    auto count = juce::jmin(numPartitions, stage.numValid);
+
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        // --- spectrum of the previous and the current block, which then becomes the previous
+        float* input = &stage.input[2 * lane * size];
+        std::copy(input, input + 2 * size, scratch);
+        std::fill(scratch + 2 * size, scratch + 4 * size, 0.0f);
+        stage.fft.performRealOnlyForwardTransform(scratch, true);
+        float* delayLine = &stage.delayLine[(size_t)lane * stage.capacity * spectrumSize];
+        std::copy(scratch, scratch + spectrumSize, delayLine + stage.newest * spectrumSize);
+        std::copy(input + size, input + 2 * size, input);
+
+        // --- partition j meets the block j - 1 blocks before the newest
+        std::fill(scratch, scratch + 4 * size, 0.0f);
+        for (int partition = 1; partition <= count; partition++)
+        {
+            auto slot = stage.newest - (partition - 1);
+            const float* x = delayLine + (slot < 0 ? slot + stage.capacity : slot) * spectrumSize;
+            const float* h = spectra + (partition - 1) * spectrumSize;
+            for (int bin = 0; bin < spectrumSize; bin += 2)
+            {
+                scratch[bin] += x[bin] * h[bin] - x[bin + 1] * h[bin + 1];
+                scratch[bin + 1] += x[bin] * h[bin + 1] + x[bin + 1] * h[bin];
+            }
+        }
+        stage.fft.performRealOnlyInverseTransform(scratch);
+
+        // --- the second half is free of wrap-around, the output of the next block
+        std::copy(scratch + size, scratch + 2 * size, &stage.output[lane * size]);
+    }
+}
+
+#endif /* PartitionedConvolver_h */
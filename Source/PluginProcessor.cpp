@@ -7,7 +7,10 @@
 */
 
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+#if ! PUANNHI_HEADLESS
+ #include "PluginEditor.h"
+#endif
+#include <typeinfo>
 
 //==============================================================================
 PuannhiAudioProcessor::PuannhiAudioProcessor()
@@ -34,6 +37,7 @@ PuannhiAudioProcessor::PuannhiAudioProcessor()
 
 PuannhiAudioProcessor::~PuannhiAudioProcessor()
 {
+    stopRenderer();
 }
 
 //==============================================================================
@@ -104,70 +108,267 @@ void PuannhiAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBloc
     // Use this method as the place to do any pre-playback
     // initialisation that you need..
     
-    CB_1.reset(new CircularBuffer<float>[getTotalNumInputChannels()]);
-    CB_2.reset(new CircularBuffer<float>[getTotalNumInputChannels()]);
-    CB_3.reset(new CircularBuffer<float>[getTotalNumInputChannels()]);
-    CB_4.reset(new CircularBuffer<float>[getTotalNumInputChannels()]);
+    // memory is only ever allocated when this configuration needs more than the previous one,
+    // re-preparing with the same or a smaller one reuses it and just resets the state
+    stopRenderer();
+    mEngine = mEngineOptions;
 
-    PreDelay.reset(new DelayFeedback<float>[getTotalNumInputChannels()]);
+    auto numChannels = getTotalNumInputChannels();
+    auto numPairs = numChannels / 2;
+    auto numSingles = numChannels % 2;
 
-    mCoefficient.model = 4;
+    if (numPairs > mNumPairsAllocated)
+    {
+        mStereoFrozen.reset(new FrozenNetwork<NetworkControls, 2>[numPairs]);
+        mNumPairsAllocated = numPairs;
+    }
+    if (numSingles > mNumSinglesAllocated)
+    {
+        mFrozen.reset(new FrozenNetwork<NetworkControls, 1>[numSingles]);
+        mNumSinglesAllocated = numSingles;
+    }
+    if (numChannels > mNumChannelsAllocated)
+    {
+        PreDelay.reset(new DelayFeedback<float, PreDelayInterpolation, PreDelayStorage>[numChannels]);
+        mNumChannelsAllocated = numChannels;
+    }
+    mNumChannels = numChannels;
+
+    // size every line for the longest delay the parameter ranges allow at this sample rate,
+    // the depth is in samples at 44.1 kHz, plus the two samples the 4-point kernels read past the tap
+    auto maxDepth = mDepth->range.end * sampleRate / PrimeDelayTable<FeedbackNetwork<float>::kNumLines>::kReferenceRate;
+    auto feedbackLength = (unsigned int)ceil((FeedbackNetwork<float>::getMaxDelayLength(sampleRate) + maxDepth) * mSize->range.end) + 3;
+    auto preDelayLength = (unsigned int)ceil(mPreDelay->range.end / 1000 * sampleRate + 1) + 3;
+    auto preDelaySize = CircularBuffer<float, PreDelayInterpolation, PreDelayStorage>::getRequiredLength(preDelayLength);
 
-    for (int index = 0; index < getTotalNumInputChannels(); index++)
+    // the networks of the storage type in use take the arena first, the pre-delays the rest
+    withNetworks([&](auto& networks)
     {
-        CB_1[index].createCircularBuffer(4096);
-        CB_1[index].flushBuffer();
+        createNetworks(networks, sampleRate, feedbackLength, numChannels * DelayArena::align(preDelaySize * sizeof(PreDelayStorage)));
+    });
 
-        CB_2[index].createCircularBuffer(4096);
-        CB_2[index].flushBuffer();
+    mCoefficient.model = 4;
 
-        CB_3[index].createCircularBuffer(4096);
-        CB_3[index].flushBuffer();
+    // scratch rows for every network job, and a helper thread for every job but the one the
+    // audio thread runs itself. resize() keeps the capacity, so these only grow
+    auto numJobs = numPairs + numSingles;
+    mScratchSize = juce::jmax(1, samplesPerBlock);
+    mSizeScratch.resize(numJobs * mScratchSize);
+    mPreDelayInput.resize(numJobs * 2 * mScratchSize);
+    mPreDelayTime.resize(numJobs * mScratchSize);
+    mSilence.resize(mScratchSize);
+    mChannelData.resize(numChannels);
+    mControls.resize(numChannels);
+    mMixBlock.resize(numChannels);
+
+    auto numWorkers = juce::jmax(0, juce::jmin(numJobs - 1, (int)std::thread::hardware_concurrency() - 1, mEngine.maxWorkerThreads));
+    if (numWorkers != mWorkerPool.getNumWorkers())
+    {
+        mWorkerPool.start(numWorkers);
+    }
 
-        CB_4[index].createCircularBuffer(4096);
-        CB_4[index].flushBuffer();
+    for (int index = 0; index < numChannels; index++)
+    {
+        PreDelay[index].digitalDelayLine.createCircularBuffer(preDelayLength, mDelayArena.take<PreDelayStorage>(preDelaySize));
+    }
 
-        PreDelay[index].digitalDelayLine.createCircularBuffer(8192);
-        PreDelay[index].digitalDelayLine.flushBuffer();
-        
-        mMixCtrl.push_back(ParameterSmooth());
+    if (frozenConvolution)
+    {
+        auto maxLength = (int)(frozenMaxTime * sampleRate);
+        auto holdTime = (int)(frozenHoldTime * sampleRate);
+        for (int index = 0; index < numPairs; index++)
+        {
+            mStereoFrozen[index].prepare(maxLength, holdTime);
+        }
+        for (int index = 0; index < numSingles; index++)
+        {
+            mFrozen[index].prepare(maxLength, holdTime);
+        }
+        mResponse.resize(maxLength);
+    }
+
+    mMixCtrl.resize(numChannels);
+    mPreDelayCtrl.resize(numChannels);
+    mDampCtrl.resize(numChannels);
+    mColorCtrl.resize(numChannels);
+    mDecayCtrl.resize(numChannels);
+    mSizeCtrl.resize(numChannels);
+    mDepthCtrl.resize(numChannels);
+    mSpeedCtrl.resize(numChannels);
+    mSizeRamp.resize(numChannels);
+    mPreDelayRamp.resize(numChannels);
+
+    for (int index = 0; index < numChannels; index++)
+    {
         mMixCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+        // pre-delay and size are smoothed at the control rate, same time constant in seconds
+        mPreDelayCtrl[index].createCoefficients(sampleRate * 0.001, sampleRate / mEngine.controlRate);
+        mDampCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+        mColorCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+        mDecayCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+        mSizeCtrl[index].createCoefficients(sampleRate * 0.001, sampleRate / mEngine.controlRate);
+        mDepthCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+        mSpeedCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+        mSizeRamp[index].setControlRate(mEngine.controlRate);
+        mPreDelayRamp[index].setControlRate(mEngine.controlRate);
+    }
 
-        mPreDelayCtrl.push_back(ParameterSmooth());
-        mPreDelayCtrl[index].createCoefficients(sampleRate * 0.001, sampleRate);
+    if (frozenConvolution)
+    {
+        startRenderer();
+    }
+}
 
-        mDampCtrl.push_back(ParameterSmooth());
-        mDampCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+template <typename Storage>
+void PuannhiAudioProcessor::createNetworks(NetworkSet<Storage>& networks, double sampleRate, unsigned int feedbackLength, size_t preDelayBytes)
+{
+    auto numPairs = mNumChannels / 2;
+    auto numSingles = mNumChannels % 2;
 
-        mColorCtrl.push_back(ParameterSmooth());
-        mColorCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+    if (numPairs > networks.numPairsAllocated)
+    {
+        networks.stereo.reset(new StereoFeedbackNetwork<Storage>[numPairs]);
+        networks.numPairsAllocated = numPairs;
+    }
+    if (numSingles > networks.numSinglesAllocated)
+    {
+        networks.mono.reset(new FeedbackNetwork<Storage>[numSingles]);
+        networks.numSinglesAllocated = numSingles;
+    }
 
-        mDecayCtrl.push_back(ParameterSmooth());
-        mDecayCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+    auto stereoFeedbackSize = StereoFeedbackNetwork<Storage>::getRequiredLength(feedbackLength);
+    auto feedbackSize = FeedbackNetwork<Storage>::getRequiredLength(feedbackLength);
+    mDelayArena.reserve(numPairs * DelayArena::align(stereoFeedbackSize * sizeof(Storage))
+                      + numSingles * DelayArena::align(feedbackSize * sizeof(Storage))
+                      + preDelayBytes);
+
+    // hand every line its piece of the arena, this also clears it
+    auto setUp = [this, sampleRate](auto& network)
+    {
+        network.setSampleRate(sampleRate);
+        network.setControlRate(mEngine.controlRate);
+        for (int line = 0; line < network.kNumLines; line++)
+        {
+            network.setModulationShape(line, modulationShape);
+        }
+    };
+    for (int index = 0; index < numPairs; index++)
+    {
+        networks.stereo[index].createFeedbackDelayNetwork(feedbackLength, mDelayArena.take<Storage>(stereoFeedbackSize));
+        setUp(networks.stereo[index]);
+    }
+    for (int index = 0; index < numSingles; index++)
+    {
+        networks.mono[index].createFeedbackDelayNetwork(feedbackLength, mDelayArena.take<Storage>(feedbackSize));
+        setUp(networks.mono[index]);
+    }
 
-        mSizeCtrl.push_back(ParameterSmooth());
-        mSizeCtrl[index].createCoefficients(sampleRate * 0.001, sampleRate);
+    if (frozenConvolution)
+    {
+        if (networks.render == nullptr)
+        {
+            networks.render.reset(new FeedbackNetwork<Storage>());
+        }
+        mRenderArena.reserve(DelayArena::align(feedbackSize * sizeof(Storage)));
+        networks.render->createFeedbackDelayNetwork(feedbackLength, mRenderArena.take<Storage>(feedbackSize));
+        setUp(*networks.render);
+    }
+}
 
-        mDepthCtrl.push_back(ParameterSmooth());
-        mDepthCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+template <typename Function>
+void PuannhiAudioProcessor::withNetworks(Function function)
+{
+    switch (mEngine.feedbackStorage)
+    {
+        case E_HALF_FLOAT_STORAGE:
+            function(mHalfFloatNetworks);
+            break;
+        case E_DITHERED_INT16_STORAGE:
+            function(mDitheredInt16Networks);
+            break;
+        default:
+            function(mFloatNetworks);
+            break;
+    }
+}
 
-        mSpeedCtrl.push_back(ParameterSmooth());
-        mSpeedCtrl[index].createCoefficients(sampleRate * 0.0001, sampleRate);
+void PuannhiAudioProcessor::setEngineOptions(const EngineOptions& options)
+{
+    mEngineOptions = options;
+}
+
+const PuannhiAudioProcessor::EngineOptions& PuannhiAudioProcessor::getEngineOptions() const
+{
+    return mEngineOptions;
+}
+
+juce::String PuannhiAudioProcessor::getConfiguration() const
+{
+    // the line lengths at the reference rate stand for the delay table, the interpolation and
+    // storage types for themselves by their type names; the worker threads leave the output alone
+    float lengths[FeedbackNetwork<float>::kNumLines];
+    FeedbackNetwork<float>::getDelayLengths(lengths, PrimeDelayTable<FeedbackNetwork<float>::kNumLines>::kReferenceRate);
+    juce::String delayLengths;
+    for (auto length : lengths)
+    {
+        delayLengths << (delayLengths.isEmpty() ? "" : "/") << (int)length;
+    }
+
+    juce::String configuration;
+    configuration << "lines=" << FeedbackNetwork<float>::kNumLines
+                  << ";delay_lengths=" << delayLengths
+                  << ";feedback_interpolation=" << typeid(FeedbackInterpolation).name()
+                  << ";pre_delay_interpolation=" << typeid(PreDelayInterpolation).name()
+                  << ";feedback_storage=" << mEngineOptions.feedbackStorage
+                  << ";pre_delay_storage=" << typeid(PreDelayStorage).name()
+                  << ";block_processing=" << (int)mEngineOptions.blockProcessing
+                  << ";control_rate=" << mEngineOptions.controlRate
+                  << ";modulation_shape=" << modulationShape
+                  << ";absorption=" << (int)mEngineOptions.absorptionFilters
+                  << ";low_decay_ratio=" << lowDecayRatio
+                  << ";low_crossover=" << lowCrossover
+                  << ";frozen_convolution=" << (int)frozenConvolution
+                  << ";frozen_hold_time=" << frozenHoldTime
+                  << ";frozen_max_time=" << frozenMaxTime;
+    return configuration;
+}
 
-        mFilter_1.push_back(juce::IIRFilter());
-        mFilter_2.push_back(juce::IIRFilter());
-        mFilter_3.push_back(juce::IIRFilter());
-        mFilter_4.push_back(juce::IIRFilter());
-        
-        feedbackLoop_1.push_back(0.0f);
-        feedbackLoop_2.push_back(0.0f);
-        feedbackLoop_3.push_back(0.0f);
-        feedbackLoop_4.push_back(0.0f);
-
-        modulator_1.push_back(Oscillator());
-        modulator_2.push_back(Oscillator());
-        modulator_3.push_back(Oscillator());
-        modulator_4.push_back(Oscillator());
+void PuannhiAudioProcessor::reset()
+{
+    // clear every line, filter, modulator and smoother in place, without touching the heap
+    withNetworks([this](auto& networks)
+    {
+        for (int index = 0; index < mNumChannels / 2; index++)
+        {
+            networks.stereo[index].flushBuffer();
+        }
+        for (int index = 0; index < mNumChannels % 2; index++)
+        {
+            networks.mono[index].flushBuffer();
+        }
+    });
+    for (int index = 0; index < mNumChannels / 2; index++)
+    {
+        mStereoFrozen[index].reset();
+    }
+    for (int index = 0; index < mNumChannels % 2; index++)
+    {
+        mFrozen[index].reset();
+    }
+    for (int index = 0; index < mNumChannels; index++)
+    {
+        PreDelay[index].digitalDelayLine.flushBuffer();
+
+        mMixCtrl[index].reset();
+        mPreDelayCtrl[index].reset();
+        mDampCtrl[index].reset();
+        mColorCtrl[index].reset();
+        mDecayCtrl[index].reset();
+        mSizeCtrl[index].reset();
+        mDepthCtrl[index].reset();
+        mSpeedCtrl[index].reset();
+        mSizeRamp[index].reset();
+        mPreDelayRamp[index].reset();
     }
 }
 
@@ -175,6 +376,10 @@ void PuannhiAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+
+    // no helper threads while stopped, prepareToPlay() starts them again
+    stopRenderer();
+    mWorkerPool.stop();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -184,10 +389,9 @@ bool PuannhiAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Every channel gets its own reverb, so any layout works, from mono up to
+    // immersive and ambisonic layouts.
+    if (layouts.getMainOutputChannelSet() == juce::AudioChannelSet::disabled())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -216,88 +420,318 @@ void PuannhiAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
-    // This is the place where you'd normally do the guts of your plugin's
-    // audio processing...
-    // Make sure to reset the state if your inner loop is processing
-    // the samples and the outer loop is handling the channels.
-    // Alternatively, you can process the samples with the channels
-    // interleaved by keeping the same state.
-    for (int channel = 0; channel < totalNumInputChannels; ++channel)
-    {   
-        auto* channelData = buffer.getWritePointer (channel);
-
-        auto mixCtrl = mMixCtrl[channel].process(mMix->get());
-        auto speedCtrl = mSpeedCtrl[channel].process(mSpeed->get());
-        auto decayCtrl = mDecayCtrl[channel].process(mDecay->get());
-        auto dampCtrl = mDampCtrl[channel].process(mDamp->get());
-        auto colorCtrl = mColorCtrl[channel].process(mColor->get());
-        auto depthCtrl = mDepthCtrl[channel].process(mDepth->get());
-
-        mCoefficient.setParameter(colorCtrl, getSampleRate(), 0, 0, 0);
-        mFilter_1[channel].setCoefficients(juce::IIRCoefficients(mCoefficient.getCoefficients()[0], 0, 0, mCoefficient.getCoefficients()[3], mCoefficient.getCoefficients()[4], 0));
-        mFilter_2[channel].setCoefficients(juce::IIRCoefficients(mCoefficient.getCoefficients()[0], 0, 0, mCoefficient.getCoefficients()[3], mCoefficient.getCoefficients()[4], 0));
-        mFilter_3[channel].setCoefficients(juce::IIRCoefficients(mCoefficient.getCoefficients()[0], 0, 0, mCoefficient.getCoefficients()[3], mCoefficient.getCoefficients()[4], 0));
-        mFilter_4[channel].setCoefficients(juce::IIRCoefficients(mCoefficient.getCoefficients()[0], 0, 0, mCoefficient.getCoefficients()[3], mCoefficient.getCoefficients()[4], 0));
-
-        for (int sample = 0; sample < buffer.getNumSamples(); sample++)
+    // every channel pair shares one stereo network, an odd last channel has its own. The
+    // networks are independent jobs, spread over the worker pool and the calling thread
+    for (int channel = 0; channel < totalNumInputChannels; channel++)
+    {
+        mChannelData[channel] = buffer.getWritePointer(channel);
+    }
+
+    auto numPairs = totalNumInputChannels / 2;
+    withNetworks([this, numPairs, totalNumInputChannels](auto& networks)
+    {
+        for (int pair = 0; pair < numPairs; pair++)
+        {
+            prepareNetwork(networks.stereo[pair], 2 * pair);
+        }
+        if (totalNumInputChannels % 2 == 1)
         {
-            // ..do something to the data...
-            auto drySignal = channelData[sample];
-
-            // ramping process 
-            auto preDelayCtrl = mPreDelayCtrl[channel].process(mPreDelay->get()) / 1000;
-            auto sizeCtrl = mSizeCtrl[channel].process(mSize->get());
-
-            auto modulation_1 = modulator_1[channel].process(speedCtrl, getSampleRate(), 0, 0);
-            auto modulation_2 = modulator_2[channel].process(speedCtrl, getSampleRate(), 0, 0.25 * TWO_PI);
-            auto modulation_3 = modulator_3[channel].process(speedCtrl, getSampleRate(), 0, 0.50 * TWO_PI);
-            auto modulation_4 = modulator_4[channel].process(speedCtrl, getSampleRate(), 0, 0.75 * TWO_PI);
-
-            feedbackLoop_1[channel] = CB_1[channel].readBuffer((2819.0f + modulation_1 * depthCtrl)* sizeCtrl, true);
-            feedbackLoop_2[channel] = CB_2[channel].readBuffer((3343.0f + modulation_2 * depthCtrl)* sizeCtrl, true);
-            feedbackLoop_3[channel] = CB_3[channel].readBuffer((3581.0f + modulation_3 * depthCtrl)* sizeCtrl, true);
-            feedbackLoop_4[channel] = CB_4[channel].readBuffer((4133.0f + modulation_4 * depthCtrl)* sizeCtrl, true);
-
-            auto lpf_1 = mFilter_1[channel].processSingleSampleRaw(feedbackLoop_1[channel]);
-            auto lpf_2 = mFilter_2[channel].processSingleSampleRaw(feedbackLoop_2[channel]);
-            auto lpf_3 = mFilter_3[channel].processSingleSampleRaw(feedbackLoop_3[channel]);
-            auto lpf_4 = mFilter_4[channel].processSingleSampleRaw(feedbackLoop_4[channel]);
-
-            auto damp_output_1 = (lpf_1 - feedbackLoop_1[channel]) * dampCtrl;
-            auto damp_output_2 = (lpf_2 - feedbackLoop_2[channel]) * dampCtrl;
-            auto damp_output_3 = (lpf_3 - feedbackLoop_3[channel]) * dampCtrl;
-            auto damp_output_4 = (lpf_4 - feedbackLoop_4[channel]) * dampCtrl;
-
-            auto A = (damp_output_1 + feedbackLoop_1[channel]) * 0.5f * (decayCtrl * 0.25 + 0.75) + drySignal;
-            auto B = (damp_output_2 + feedbackLoop_2[channel]) * 0.5f * (decayCtrl * 0.25 + 0.75) + drySignal;
-            auto C = (damp_output_3 + feedbackLoop_3[channel]) * 0.5f * (decayCtrl * 0.25 + 0.75);
-            auto D = (damp_output_4 + feedbackLoop_4[channel]) * 0.5f * (decayCtrl * 0.25 + 0.75);
-                        
-            auto output_1 = (A + B + C + D);
-            auto output_2 = (A - B + C - D);
-            auto output_3 = (A + B - C - D);
-            auto output_4 = (A - B - C + D);
-
-            CB_1[channel].writeBuffer(output_1);
-            CB_2[channel].writeBuffer(output_2);
-            CB_3[channel].writeBuffer(output_3);
-            CB_4[channel].writeBuffer(output_4);
-
-            channelData[sample] = PreDelay[channel].process(output_1 * 0.25f, preDelayCtrl * getSampleRate() + 1, 0, 1) * mixCtrl + drySignal * (1 - mixCtrl);
+            prepareNetwork(networks.mono[0], totalNumInputChannels - 1);
         }
+    });
+
+    mNumSamples = buffer.getNumSamples();
+    auto numJobs = numPairs + totalNumInputChannels % 2;
+    // workers give up on jobs they could not start within half the block
+    mWorkerPool.run([](void* context, int job)
+    {
+        auto* processor = static_cast<PuannhiAudioProcessor*>(context);
+        processor->withNetworks([processor, job](auto& networks)
+        {
+            processor->processJob(networks, job);
+        });
+    }, this, numJobs, 0.5 * mNumSamples / getSampleRate());
+}
+
+template <typename Storage>
+void PuannhiAudioProcessor::processJob(NetworkSet<Storage>& networks, int job)
+{
+    if (job < getTotalNumInputChannels() / 2)
+    {
+        processNetwork(networks.stereo[job], mStereoFrozen[job], job, 2 * job);
+    }
+    else
+    {
+        processNetwork(networks.mono[0], mFrozen[0], job, getTotalNumInputChannels() - 1);
+    }
+}
+
+template <typename Network>
+void PuannhiAudioProcessor::prepareNetwork(Network& network, int firstChannel)
+{
+    // all channels see the same parameters, the lanes run on the smoothed controls of the first
+    auto& controls = mControls[firstChannel];
+    controls.speed = mSpeedCtrl[firstChannel].process(mSpeed->get());
+    controls.decay = mDecayCtrl[firstChannel].process(mDecay->get());
+    controls.damp = mDampCtrl[firstChannel].process(mDamp->get());
+    auto colorCtrl = mColorCtrl[firstChannel].process(mColor->get());
+    controls.depth = mDepthCtrl[firstChannel].process(mDepth->get());
+
+    for (int lane = 0; lane < Network::kNumLanes; lane++)
+    {
+        mMixBlock[firstChannel + lane] = mMixCtrl[firstChannel + lane].process(mMix->get());
+    }
+
+    mCoefficient.setParameter(colorCtrl, getSampleRate(), 0, 0, 0);
+    // model 4 is a one-pole low-pass, normalised so its b0 is 1
+    auto coefficients = mCoefficient.getCoefficients();
+    controls.gain = coefficients[0];
+    controls.pole = -coefficients[4];
+
+    if (mEngine.absorptionFilters)
+    {
+        // the T60 at which the mean line loses as much per pass as decay takes off in the broadband path
+        auto meanLength = network.getMeanDelayLength();
+        auto decayGain = controls.decay * 0.25 + 0.75;
+        auto midDecayTime = decayGain < 1 ? (float)(-3 * meanLength / getSampleRate() / log10(decayGain)) : std::numeric_limits<float>::infinity();
+        controls.decayTime[0] = midDecayTime * lowDecayRatio;
+        controls.decayTime[1] = midDecayTime;
+        controls.decayTime[2] = midDecayTime * (1 - 0.75f * controls.damp);
+        controls.decayTime[3] = lowCrossover;
+        controls.decayTime[4] = colorCtrl;
+    }
+
+    applyControls(network, controls);
+}
+
+template <typename Network>
+void PuannhiAudioProcessor::applyControls(Network& network, const NetworkControls& controls)
+{
+    network.setCoefficients(controls.gain, controls.pole);
+    network.setParameter(controls.speed, controls.depth, controls.damp, controls.decay, getSampleRate());
+
+    network.setAbsorption(mEngine.absorptionFilters);
+    if (mEngine.absorptionFilters)
+    {
+        network.setDecayTime(controls.decayTime[0], controls.decayTime[1], controls.decayTime[2], controls.decayTime[3], controls.decayTime[4]);
     }
 }
 
+template <typename Network, typename Frozen>
+void PuannhiAudioProcessor::processNetwork(Network& network, Frozen& frozen, int job, int firstChannel)
+{
+    const int numLanes = Network::kNumLanes;
+
+    // every job works in its own rows of the scratch
+    auto scratchSize = mScratchSize;
+    float* sizeRamp = mSizeScratch.data() + job * scratchSize;
+    float* preDelayTime = mPreDelayTime.data() + job * scratchSize;
+    float* preDelayInput = mPreDelayInput.data() + job * numLanes * scratchSize;
+
+    // the host may send more samples than announced in prepareToPlay, so run in chunks of the scratch size
+    for (int start = 0; start < mNumSamples; start += scratchSize)
+    {
+        auto numSamples = juce::jmin(scratchSize, mNumSamples - start);
+
+        const float* channelData[numLanes];
+        float* wetData[numLanes];
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            channelData[lane] = mChannelData[firstChannel + lane] + start;
+            wetData[lane] = preDelayInput + lane * scratchSize;
+        }
+
+        // ramping process, the smoother steps once per control period; static automation skips both
+        auto size = mSize->get();
+        auto sizeSettled = mSizeCtrl[firstChannel].isSettled(size) && mSizeRamp[firstChannel].isSettled(size);
+        if (sizeSettled)
+        {
+            mSizeRamp[firstChannel].hold(sizeRamp, numSamples);
+        }
+        else
+        {
+            mSizeRamp[firstChannel].process(sizeRamp, numSamples, [this, firstChannel]
+            {
+                return mSizeCtrl[firstChannel].process(mSize->get());
+            });
+        }
+
+        // with the modulation off and the controls held the network may run as its convolution
+        if (frozenConvolution)
+        {
+            auto& controls = mControls[firstChannel];
+            controls.size = sizeRamp[0];
+            frozen.update(controls, sizeSettled && controls.depth == 0, numSamples);
+        }
+
+        const float* networkInput[numLanes];
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            networkInput[lane] = frozen.feedsNetwork() ? channelData[lane] : mSilence.data();
+        }
+
+        if (!frozen.runsNetwork())
+        {
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                std::fill(wetData[lane], wetData[lane] + numSamples, 0.0f);
+            }
+        }
+        else if (mEngine.blockProcessing)
+        {
+            network.processBlock(networkInput, wetData, sizeRamp, numSamples);
+        }
+        else
+        {
+            for (int sample = 0; sample < numSamples; sample++)
+            {
+                float input[numLanes];
+                float output[numLanes];
+                for (int lane = 0; lane < numLanes; lane++)
+                {
+                    input[lane] = networkInput[lane][sample];
+                }
+                network.processSample(input, output, sizeRamp[sample]);
+                for (int lane = 0; lane < numLanes; lane++)
+                {
+                    wetData[lane][sample] = output[lane];
+                }
+            }
+        }
+        frozen.process(channelData, wetData, numSamples);
+
+        for (int lane = 0; lane < numLanes; lane++)
+        {
+            auto channel = firstChannel + lane;
+            auto* outputData = mChannelData[channel] + start;
+
+            auto preDelay = mPreDelay->get();
+            if (mPreDelayCtrl[channel].isSettled(preDelay) && mPreDelayRamp[channel].isSettled((float)(preDelay / 1000 * getSampleRate() + 1)))
+            {
+                mPreDelayRamp[channel].hold(preDelayTime, numSamples);
+            }
+            else
+            {
+                mPreDelayRamp[channel].process(preDelayTime, numSamples, [this, channel]
+                {
+                    auto preDelayCtrl = mPreDelayCtrl[channel].process(mPreDelay->get()) / 1000;
+                    return (float)(preDelayCtrl * getSampleRate() + 1);
+                });
+            }
+
+            PreDelay[channel].processBlock(wetData[lane], wetData[lane], preDelayTime, numSamples, 0, 1);
+
+            for (int sample = 0; sample < numSamples; sample++)
+            {
+                outputData[sample] = wetData[lane][sample] * mMixBlock[channel] + outputData[sample] * (1 - mMixBlock[channel]);
+            }
+        }
+    }
+}
+
+bool PuannhiAudioProcessor::NetworkControls::operator==(const NetworkControls& other) const
+{
+    return gain == other.gain && pole == other.pole && speed == other.speed && depth == other.depth
+        && damp == other.damp && decay == other.decay && size == other.size
+        && std::equal(decayTime, decayTime + 5, other.decayTime);
+}
+
+void PuannhiAudioProcessor::startRenderer()
+{
+    mRendererRunning = true;
+    mRenderer = std::thread([this] { renderResponses(); });
+}
+
+void PuannhiAudioProcessor::stopRenderer()
+{
+    mRendererRunning = false;
+    if (mRenderer.joinable())
+    {
+        mRenderer.join();
+    }
+}
+
+void PuannhiAudioProcessor::renderResponses()
+{
+    // a request waits for at most one poll, short next to the hold time
+    while (mRendererRunning)
+    {
+        for (int index = 0; index < mNumChannels / 2; index++)
+        {
+            if (mStereoFrozen[index].isRequested())
+            {
+                auto length = renderResponse(mStereoFrozen[index].getRequest());
+                mStereoFrozen[index].setImpulseResponse(mResponse.data(), length);
+            }
+        }
+        for (int index = 0; index < mNumChannels % 2; index++)
+        {
+            if (mFrozen[index].isRequested())
+            {
+                auto length = renderResponse(mFrozen[index].getRequest());
+                mFrozen[index].setImpulseResponse(mResponse.data(), length);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+int PuannhiAudioProcessor::renderResponse(const NetworkControls& controls)
+{
+    // the lanes of a network do not mix, so one lane from silence on the same controls gives the response of every lane
+    auto maxLength = (int)mResponse.size();
+    withNetworks([this, &controls, maxLength](auto& networks)
+    {
+        auto& network = *networks.render;
+        network.flushBuffer();
+        applyControls(network, controls);
+
+        const int blockSize = FeedbackNetwork<float>::kMaxBlockSize;
+        float input[blockSize] = {};
+        float size[blockSize];
+        std::fill(size, size + blockSize, controls.size);
+        input[0] = 1;
+
+        for (int start = 0; start < maxLength; start += blockSize)
+        {
+            network.processBlock(input, mResponse.data() + start, size, juce::jmin(blockSize, maxLength - start));
+            input[0] = 0;
+        }
+    });
+
+    // cut where less than -90 dB of the energy is left, and give up when that is not before the last tenth
+    double energy = 0;
+    for (int sample = 0; sample < maxLength; sample++)
+    {
+        energy += (double)mResponse[sample] * mResponse[sample];
+    }
+    double rest = 0;
+    int length = 0;
+    for (int sample = maxLength; sample-- > 0; )
+    {
+        rest += (double)mResponse[sample] * mResponse[sample];
+        if (rest > energy * 1.0e-9)
+        {
+            length = sample + 1;
+            break;
+        }
+    }
+    return length > maxLength - maxLength / 10 ? 0 : length;
+}
+
 //==============================================================================
 bool PuannhiAudioProcessor::hasEditor() const
 {
-    return true; // (change this to false if you choose to not supply an editor)
+    return ! PUANNHI_HEADLESS; // (change this to false if you choose to not supply an editor)
 }
 
 juce::AudioProcessorEditor* PuannhiAudioProcessor::createEditor()
 {
+   #if PUANNHI_HEADLESS
+    return nullptr;
+   #else
     return new PuannhiAudioProcessorEditor (*this);
-//    return nullptr;
+   #endif
 }
 
 //==============================================================================
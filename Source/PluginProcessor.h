@@ -10,11 +10,17 @@
 
 #include <JuceHeader.h>
 #include "CircularBuffer.h"
+#include "MultiLineDelay.h"
 #include "ParameterSmooth.h"
 #include "DelayFeedback.h"
 #include "FilterDesigner.h"
 #include "Oscillator.h"
 #include "DelayAPF.h"
+#include "DelayArena.h"
+#include "FeedbackDelayNetwork.h"
+#include "WorkerPool.h"
+#include "ControlRamp.h"
+#include "FrozenNetwork.h"
 
 //==============================================================================
 /**
@@ -22,6 +28,54 @@
 
 const bool debug = false;
 
+// set to 1 by headless builds such as the tools app, which leave out the editor and its GUI code
+#ifndef PUANNHI_HEADLESS
+ #define PUANNHI_HEADLESS 0
+#endif
+
+// run the network stage by stage over sub-blocks instead of sample by sample, same output
+const bool blockProcessing = true;
+
+// samples per evaluation of the modulators and of the per-sample smoothers, linear ramps in
+// between; 1 evaluates everything at audio rate
+const int controlRate = 16;
+
+// shape of the feedback modulators, any E_OSCILLATOR_TYPE; other shapes than E_SINE run from wavetables
+const int modulationShape = E_SINE;
+
+// per-line absorption shelves sized to every delay line instead of the broadband decay and the
+// shared damping: decay sets the T60 of the middle band, damping shortens it above the brightness
+const bool absorptionFilters = false;
+const float lowDecayRatio = 1.2f;
+const float lowCrossover = 250.0f;
+
+// interpolation kernels of the modulated feedback taps and of the pre-delay, see Interpolation.h
+using FeedbackInterpolation = HermiteInterpolation;
+using PreDelayInterpolation = HermiteInterpolation;
+
+// sample format of the feedback lines, any E_STORAGE_TYPE, and of the pre-delay; HalfFloat or
+// DitheredInt16 halve the delay memory, see SampleStorage.h
+const int feedbackStorage = E_FLOAT_STORAGE;
+using PreDelayStorage = float;
+
+// the feedback network, 4 lines; any power of two works, more lines give a denser tail.
+// channel pairs run as the two lanes of one stereo network, an odd last channel runs alone
+template <typename Storage>
+using FeedbackNetwork = FDN<4, FeedbackInterpolation, Storage>;
+template <typename Storage>
+using StereoFeedbackNetwork = FDN<4, FeedbackInterpolation, Storage, 2>;
+
+// run a network whose controls have held for frozenHoldTime seconds with no modulation depth
+// as the convolution with its impulse response, rendered on a background thread and cut where
+// it has decayed by 90 dB, see FrozenNetwork.h. Responses that take longer than frozenMaxTime
+// seconds keep the network. A 4-line network costs less than the convolution, so this is off
+const bool frozenConvolution = false;
+const float frozenHoldTime = 0.25f;
+const float frozenMaxTime = 10.0f;
+
+// helper threads for wide layouts, the audio thread always takes part itself
+const int maxWorkerThreads = 7;
+
 class PuannhiAudioProcessor  : public juce::AudioProcessor
 {
 public:
@@ -32,6 +86,7 @@ public:
     //==============================================================================
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
    #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported (const BusesLayout& layouts) const override;
@@ -62,30 +117,133 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+    //==============================================================================
+    // the engine the processor runs, the consts above unless set otherwise; takes effect at
+    // the next prepareToPlay()
+    struct EngineOptions
+    {
+        bool blockProcessing = ::blockProcessing;
+        int controlRate = ::controlRate;
+        int feedbackStorage = ::feedbackStorage;
+        bool absorptionFilters = ::absorptionFilters;
+        // 0 runs every network on the thread that calls processBlock()
+        int maxWorkerThreads = ::maxWorkerThreads;
+    };
+
+    void setEngineOptions(const EngineOptions& options);
+    const EngineOptions& getEngineOptions() const;
+
+    // everything besides the parameters, the sample rate and the layout that shapes the output:
+    // the consts above and the engine options, as one line of text to compare or hash
+    juce::String getConfiguration() const;
+
 private:
-    std::unique_ptr<CircularBuffer<float>[]> CB_1;
-    std::unique_ptr<CircularBuffer<float>[]> CB_2;
-    std::unique_ptr<CircularBuffer<float>[]> CB_3;
-    std::unique_ptr<CircularBuffer<float>[]> CB_4;
+    // the block rate controls of a network, and the size it runs at
+    struct NetworkControls
+    {
+        float gain = 0;
+        float pole = 0;
+        float speed = 0;
+        float depth = 0;
+        float damp = 0;
+        float decay = 0;
+        float size = 0;
+        // low, middle and high T60 and the crossovers of the absorption shelves
+        float decayTime[5] = {};
+
+        bool operator==(const NetworkControls& other) const;
+    };
+
+    // the networks of one feedback storage type: one per channel pair, one for an odd last
+    // channel and the one the renderer runs. Only the type in use is allocated
+    template <typename Storage>
+    struct NetworkSet
+    {
+        std::unique_ptr<StereoFeedbackNetwork<Storage>[]> stereo;
+        std::unique_ptr<FeedbackNetwork<Storage>[]> mono;
+        std::unique_ptr<FeedbackNetwork<Storage>> render;
+        int numPairsAllocated = 0;
+        int numSinglesAllocated = 0;
+    };
 
-    std::unique_ptr<DelayFeedback<float>[]> PreDelay;
+    // calls function with the network set of the storage type prepared for
+    template <typename Function>
+    void withNetworks(Function function);
+
+    // sizes and creates the networks of the set, their memory and preDelayBytes more come from the arena
+    template <typename Storage>
+    void createNetworks(NetworkSet<Storage>& networks, double sampleRate, unsigned int feedbackLength, size_t preDelayBytes);
+
+    // runs the network of job number job of the worker pool
+    template <typename Storage>
+    void processJob(NetworkSet<Storage>& networks, int job);
+
+    // sets the block rate controls of the network that runs channels firstChannel ..
+    // firstChannel + Network::kNumLanes - 1, the controls of the first of them
+    template <typename Network>
+    void prepareNetwork(Network& network, int firstChannel);
+
+    template <typename Network>
+    void applyControls(Network& network, const NetworkControls& controls);
+
+    // runs the channels of one network as job number job of the worker pool
+    template <typename Network, typename Frozen>
+    void processNetwork(Network& network, Frozen& frozen, int job, int firstChannel);
+
+    // the background thread that renders the responses the frozen networks ask for
+    void startRenderer();
+    void stopRenderer();
+    void renderResponses();
+    // renders the response of controls into mResponse, returns its length, 0 when it does not decay in time
+    int renderResponse(const NetworkControls& controls);
+
+    // set by setEngineOptions(), and the options prepareToPlay() last took from it
+    EngineOptions mEngineOptions;
+    EngineOptions mEngine;
+
+    WorkerPool mWorkerPool;
+
+    // holds the memory of every delay line below
+    DelayArena mDelayArena;
+
+    // the feedback networks of every storage type, and the frozen twin of every network
+    NetworkSet<float> mFloatNetworks;
+    NetworkSet<HalfFloat> mHalfFloatNetworks;
+    NetworkSet<DitheredInt16> mDitheredInt16Networks;
+    std::unique_ptr<FrozenNetwork<NetworkControls, 2>[]> mStereoFrozen;
+    std::unique_ptr<FrozenNetwork<NetworkControls, 1>[]> mFrozen;
+    // the block rate controls of every network, at its first channel
+    std::vector<NetworkControls> mControls;
+
+    // the renderer has a network, in the network set, and delay memory of its own
+    std::thread mRenderer;
+    std::atomic<bool> mRendererRunning { false };
+    DelayArena mRenderArena;
+    std::vector<float> mResponse;
+
+    // channels prepared for, and the most the arrays of networks and pre-delays hold
+    int mNumChannels = 0;
+    int mNumPairsAllocated = 0;
+    int mNumSinglesAllocated = 0;
+    int mNumChannelsAllocated = 0;
+
+    std::unique_ptr<DelayFeedback<float, PreDelayInterpolation, PreDelayStorage>[]> PreDelay;
 
     FilterDesigner mCoefficient;
     
-    std::vector<float> feedbackLoop_1;
-    std::vector<float> feedbackLoop_2;
-    std::vector<float> feedbackLoop_3;
-    std::vector<float> feedbackLoop_4;
-
-    std::vector<juce::IIRFilter> mFilter_1;
-    std::vector<juce::IIRFilter> mFilter_2;
-    std::vector<juce::IIRFilter> mFilter_3;
-    std::vector<juce::IIRFilter> mFilter_4;
+    // scratch for the network and the pre-delay, which run block-wise, mScratchSize samples per
+    // row, one row per job and, for mPreDelayInput, per lane
+    int mScratchSize = 0;
+    std::vector<float> mSizeScratch;
+    std::vector<float> mPreDelayInput;
+    std::vector<float> mPreDelayTime;
+    // fed to a network that rings out while its frozen twin takes the input
+    std::vector<float> mSilence;
 
-    std::vector<Oscillator> modulator_1;
-    std::vector<Oscillator> modulator_2;
-    std::vector<Oscillator> modulator_3;
-    std::vector<Oscillator> modulator_4;
+    // the current block, handed to the jobs
+    int mNumSamples = 0;
+    std::vector<float*> mChannelData;
+    std::vector<float> mMixBlock;
 
     juce::AudioParameterFloat* mMix;
     juce::AudioParameterFloat* mPreDelay;
@@ -105,6 +263,10 @@ private:
     std::vector<ParameterSmooth> mSpeedCtrl;
     std::vector<ParameterSmooth> mDepthCtrl;
 
+    // control rate ramps behind mSizeCtrl and mPreDelayCtrl, one per channel
+    std::vector<ControlRamp<float>> mSizeRamp;
+    std::vector<ControlRamp<float>> mPreDelayRamp;
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PuannhiAudioProcessor);
 };
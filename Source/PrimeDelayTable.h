@@ -0,0 +1,138 @@
+//
+//  PrimeDelayTable.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef PrimeDelayTable_h
+#define PrimeDelayTable_h
+
+// The line lengths of an N-line network at every sample rate, in samples. They are distinct
+// primes, so any two lines are mutually prime and their echoes never land on a common
+// multiple. The lengths are set at 44.1 kHz: the hand-tuned 2819, 3343, 3581 and 4133 for
+// N = 4, otherwise geometrically spread over the same range. For another rate each one is
+// scaled by the rate and moved up to the next prime that is longer than the line before it,
+// so every line keeps its length in seconds to within a few samples.
+//
+// The table holds the standard rates from 44.1 to 192 kHz and is built by the compiler,
+// getLengths() only looks a standard rate up. Any other rate runs the same search then.
+template <int N>
+class PrimeDelayTable
+{
+
+public:
+    constexpr PrimeDelayTable() : mLengths()
+    {
+        for (int rate = 0; rate < kNumRates; rate++)
+        {
+            searchLengths(getRate(rate), mLengths[rate]);
+        }
+    };
+
+    static const int kNumRates = 6;
+    static constexpr double kReferenceRate = 44100;
+
+    static constexpr double getRate(int index)
+    {
+        return index < 3 ? kReferenceRate * (1 << index) : 48000.0 * (1 << (index - 3));
+    }
+
+    // --- the N lengths at sampleRate, shortest first
+    void getLengths(double sampleRate, float* lengths) const
+    {
+        for (int rate = 0; rate < kNumRates; rate++)
+        {
+            if (sampleRate == getRate(rate))
+            {
+                for (int line = 0; line < N; line++)
+                {
+                    lengths[line] = (float)mLengths[rate][line];
+                }
+                return;
+            }
+        }
+
+        int search[N] = {};
+        searchLengths(sampleRate, search);
+        for (int line = 0; line < N; line++)
+        {
+            lengths[line] = (float)search[line];
+        }
+    }
+
+    static constexpr void searchLengths(double sampleRate, int* lengths)
+    {
+        int previous = 0;
+        for (int line = 0; line < N; line++)
+        {
+            int candidate = (int)(getReferenceLength(line) * sampleRate / kReferenceRate);
+            candidate = candidate > previous ? candidate : previous + 1;
+            while (!isPrime(candidate))
+            {
+                candidate++;
+            }
+            lengths[line] = candidate;
+            previous = candidate;
+        }
+    }
+
+private:
+    // --- the length of line at 44.1 kHz before it is moved to a prime
+    static constexpr double getReferenceLength(int line)
+    {
+        if (N == 4)
+        {
+            return line == 0 ? 2819.0 : line == 1 ? 3343.0 : line == 2 ? 3581.0 : 4133.0;
+        }
+        auto step = getRoot(4133.0 / 2819.0, N - 1);
+        auto length = 2819.0;
+        for (int index = 0; index < line; index++)
+        {
+            length *= step;
+        }
+        return length;
+    }
+
+    // --- newton's method for the degree-th root of value > 1, until it stops moving
+    static constexpr double getRoot(double value, int degree)
+    {
+        auto root = value;
+        for (int iteration = 0; iteration < 100; iteration++)
+        {
+            auto power = 1.0;
+            for (int index = 0; index < degree - 1; index++)
+            {
+                power *= root;
+            }
+            auto next = ((degree - 1) * root + value / power) / degree;
+            if (next == root)
+            {
+                break;
+            }
+            root = next;
+        }
+        return root;
+    }
+
+    static constexpr bool isPrime(int value)
+    {
+        if (value < 2)
+        {
+            return false;
+        }
+        for (int divisor = 2; divisor * divisor <= value; divisor++)
+        {
+            if (value % divisor == 0)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int mLengths[kNumRates][N];
+};
+
+#endif /* PrimeDelayTable_h */
@@ -0,0 +1,186 @@
+//
+//  WavetableOscillator.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef WavetableOscillator_h
+#define WavetableOscillator_h
+
+#include <math.h>
+#include <stdint.h>
+#include "Oscillator.h"
+
+// Table-driven counterpart of Oscillator for every E_OSCILLATOR_TYPE shape. The phase is a
+// 32-bit fixed-point accumulator that wraps by itself, one full period per 2^32, and every
+// shape is one precomputed period read with linear interpolation, so all shapes cost the
+// same per sample: one add, one lookup pair and one multiply-add.
+//
+// Sine, triangle and trapezoid are tabulated straight from Oscillator. The shapes with a
+// jump, sawtooth, square and both phasors, are built from their harmonic series up to
+// kNumHarmonics with lanczos sigma factors, so they do not alias at fast rates and stay
+// inside the range of the plain shape instead of ringing past it.
+class WavetableOscillator
+{
+
+public:
+    WavetableOscillator()
+    {
+        mTable = getTable(E_SINE);
+        mPhase = 0;
+        mIncrement = 0;
+        mOffset = 0;
+    };
+
+    ~WavetableOscillator()
+    {
+    };
+
+    void reset();
+    void setShape(int model);
+    void setFrequency(double frequency, double sampleRate);
+    // --- in radians, like the offset of Oscillator::process
+    void setPhaseOffset(double offset);
+    // --- the value at the current phase, then advances one step
+    double process();
+
+    static const int kTableBits = 11;
+    static const int kTableSize = 1 << kTableBits;
+    static const int kNumHarmonics = 64;
+    static const int kNumShapes = E_PHASOR_INV + 1;
+
+private:
+    // --- one period of shape model, plus a guard point so the interpolation never wraps
+    static const float* getTable(int model);
+
+    const float* mTable;
+    uint32_t mPhase;
+    uint32_t mIncrement;
+    uint32_t mOffset;
+};
+
+inline void WavetableOscillator::reset()
+{
+    mPhase = 0;
+}
+
+inline void WavetableOscillator::setShape(int model)
+{
+    mTable = getTable(model);
+}
+
+inline void WavetableOscillator::setFrequency(double frequency, double sampleRate)
+{
+    mIncrement = (uint32_t)(int64_t)(frequency / sampleRate * 4294967296.0);
+}
+
+inline void WavetableOscillator::setPhaseOffset(double offset)
+{
+    double cycles = offset / TWO_PI;
+    mOffset = (uint32_t)(int64_t)((cycles - floor(cycles)) * 4294967296.0);
+}
+
+inline double WavetableOscillator::process()
+{
+    uint32_t phase = mPhase + mOffset;
+    uint32_t index = phase >> (32 - kTableBits);
+    float frac_pos = (phase << kTableBits) * (1.0f / 4294967296.0f);
+    mPhase += mIncrement;
+    return mTable[index] + (mTable[index + 1] - mTable[index]) * frac_pos;
+}
+
+inline const float* WavetableOscillator::getTable(int model)
+{
+    // --- built once, on first use, thread-safe through the static initialisation
+    struct Tables
+    {
+        float data[kNumShapes][kTableSize + 1];
+
+        Tables()
+        {
+            Oscillator reference;
+            for (int shape = 0; shape < kNumShapes; shape++)
+            {
+                for (int index = 0; index < kTableSize; index++)
+                {
+                    double angle = TWO_PI * index / kTableSize;
+                    double value = 0;
+                    switch (shape)
+                    {
+                    case E_SINE:
+                        value = reference.sine(angle);
+                        break;
+                    case E_TRIANGLE:
+                        value = reference.triangle(angle);
+                        break;
+                    case E_TRAPEZOID:
+                        value = reference.trapezoid(angle);
+                        break;
+                    case E_SAWTOOTH:
+                        value = bandLimitedSawtooth(angle);
+                        break;
+                    case E_SQUARE:
+                        value = bandLimitedSquare(angle);
+                        break;
+                    case E_PHASOR:
+                        value = bandLimitedSawtooth(angle) * 0.5 + 0.5;
+                        break;
+                    case E_PHASOR_INV:
+                        value = bandLimitedSawtooth(angle + TWO_PI / 2) * 0.5 + 0.5;
+                        break;
+                    }
+                    data[shape][index] = (float)value;
+                }
+                // --- the bipolar series still ring slightly past +-1, scale them back inside
+                if (shape == E_SAWTOOTH || shape == E_SQUARE)
+                {
+                    float peak = 0;
+                    for (int index = 0; index < kTableSize; index++)
+                    {
+                        peak = fmaxf(peak, fabsf(data[shape][index]));
+                    }
+                    for (int index = 0; index < kTableSize && peak > 1; index++)
+                    {
+                        data[shape][index] /= peak;
+                    }
+                }
+                data[shape][kTableSize] = data[shape][0];
+            }
+        }
+
+        // --- (fract(angle / 2 pi) - 0.5) * 2, like Oscillator::sawtooth
+        static double bandLimitedSawtooth(double angle)
+        {
+            double value = 0;
+            for (int harmonic = 1; harmonic <= kNumHarmonics; harmonic++)
+            {
+                value -= sigma(harmonic) * sin(harmonic * angle) / harmonic;
+            }
+            return value * 2 / (TWO_PI / 2);
+        }
+
+        // --- sign(sin(angle)), like Oscillator::square
+        static double bandLimitedSquare(double angle)
+        {
+            double value = 0;
+            for (int harmonic = 1; harmonic <= kNumHarmonics; harmonic += 2)
+            {
+                value += sigma(harmonic) * sin(harmonic * angle) / harmonic;
+            }
+            return value * 4 / (TWO_PI / 2);
+        }
+
+        static double sigma(int harmonic)
+        {
+            double x = (TWO_PI / 2) * harmonic / (kNumHarmonics + 1);
+            return sin(x) / x;
+        }
+    };
+
+    static const Tables tables;
+    return tables.data[model < 0 || model >= kNumShapes ? E_SINE : model];
+}
+
+#endif /* WavetableOscillator_h */
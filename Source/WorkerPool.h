@@ -0,0 +1,218 @@
+//
+//  WorkerPool.h
+//  CircularBuffer
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef WorkerPool_h
+#define WorkerPool_h
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+// A few worker threads that help the audio thread through independent jobs of one block.
+// run() never blocks on a lock and never allocates: the jobs of a batch are claimed through
+// a single atomic word that holds the generation of the batch, its number of jobs and the
+// next unclaimed index, and the calling thread claims jobs just like the workers do, so a
+// batch always completes even if no worker wakes up in time. A claim is only ever checked
+// against the job count of its own generation, so a worker that comes late to one batch
+// cannot take a job of the next. Workers only start a job before the deadline of the batch,
+// after it the caller finishes the rest on its own, and it only ever waits for jobs a worker
+// is already running.
+//
+// Idle workers sleep on a condition variable, which run() signals when it publishes a batch.
+// The signal is sent without the lock, so a worker that is just going to sleep can miss it;
+// it then sleeps until its timeout and the batch is finished without it.
+class WorkerPool
+{
+
+public:
+    typedef void (*Job)(void* context, int index);
+
+    WorkerPool()
+    {
+    };
+
+    ~WorkerPool()
+    {
+        stop();
+    };
+
+    // --- start and stop the threads, not from the audio thread
+    void start(int numWorkers);
+    void stop();
+    int getNumWorkers();
+
+    // --- runs job(context, index) for every index in 0 .. numJobs - 1 and returns when all are
+    // --- done, numJobs below kMaxJobs
+    void run(Job job, void* context, int numJobs, double budgetInSeconds);
+
+    static const int kMaxJobs = 0x8000;
+
+private:
+    void workerLoop();
+    // --- claims and runs jobs of batch generation until there are none left, returns the number run
+    int runJobs(uint32_t generation, bool checkDeadline);
+
+    static int64_t now();
+
+    std::vector<std::thread> mWorkers;
+    std::atomic<bool> mQuit { false };
+
+    // --- generation of the batch in the upper 32 bits, its number of jobs in the next 16 and the
+    // --- index of the next unclaimed job in the lower 16
+    std::atomic<uint64_t> mState { 0 };
+    std::atomic<int> mFinishedJobs { 0 };
+    std::atomic<int64_t> mDeadline { 0 };
+
+    // --- written before a batch is published through mState, read only by a thread that holds
+    // --- an unfinished job of it, so the batch cannot end and the next one cannot rewrite them
+    Job mJob = nullptr;
+    void* mContext = nullptr;
+
+    // --- where idle workers sleep, and how many of them do
+    std::mutex mMutex;
+    std::condition_variable mWake;
+    std::atomic<int> mNumSleeping { 0 };
+};
+
+inline void WorkerPool::start(int numWorkers)
+{
+    stop();
+    mQuit = false;
+    for (int index = 0; index < numWorkers; index++)
+    {
+        mWorkers.emplace_back([this] { workerLoop(); });
+    }
+}
+
+inline void WorkerPool::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQuit = true;
+    }
+    mWake.notify_all();
+    for (auto& worker : mWorkers)
+    {
+        worker.join();
+    }
+    mWorkers.clear();
+}
+
+inline int WorkerPool::getNumWorkers()
+{
+    return (int)mWorkers.size();
+}
+
+inline void WorkerPool::run(Job job, void* context, int numJobs, double budgetInSeconds)
+{
+    if (mWorkers.empty() || numJobs < 2)
+    {
+        for (int index = 0; index < numJobs; index++)
+        {
+            job(context, index);
+        }
+        return;
+    }
+
+    mJob = job;
+    mContext = context;
+    mFinishedJobs.store(0, std::memory_order_relaxed);
+    mDeadline.store(now() + (int64_t)(budgetInSeconds * 1e9), std::memory_order_relaxed);
+
+    // --- publish the batch, the workers pick it up from here
+    uint32_t generation = (uint32_t)(mState.load(std::memory_order_relaxed) >> 32) + 1;
+    mState.store((uint64_t)generation << 32 | (uint64_t)numJobs << 16, std::memory_order_seq_cst);
+    if (mNumSleeping.load(std::memory_order_seq_cst) > 0)
+    {
+        mWake.notify_all();
+    }
+
+    // --- take part, then wait for the jobs still running on a worker
+    int finished = runJobs(generation, false);
+    if (finished > 0)
+    {
+        mFinishedJobs.fetch_add(finished, std::memory_order_acq_rel);
+    }
+    while (mFinishedJobs.load(std::memory_order_acquire) < numJobs)
+    {
+        std::this_thread::yield();
+    }
+}
+
+inline int WorkerPool::runJobs(uint32_t generation, bool checkDeadline)
+{
+    int finished = 0;
+    while (true)
+    {
+        if (checkDeadline && now() > mDeadline.load(std::memory_order_relaxed))
+        {
+            break;
+        }
+
+        uint64_t state = mState.load(std::memory_order_acquire);
+        if ((uint32_t)(state >> 32) != generation)
+        {
+            break;
+        }
+        if (!mState.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel))
+        {
+            continue;
+        }
+
+        // --- the count is the one of the claimed generation, whatever run() writes meanwhile
+        int index = (int)(state & 0xffff);
+        int numJobs = (int)((state >> 16) & 0xffff);
+        if (index >= numJobs)
+        {
+            break;
+        }
+        mJob(mContext, index);
+        finished++;
+    }
+    return finished;
+}
+
+inline void WorkerPool::workerLoop()
+{
+    uint32_t lastGeneration = (uint32_t)(mState.load(std::memory_order_acquire) >> 32);
+
+    while (!mQuit.load(std::memory_order_relaxed))
+    {
+        uint32_t generation = (uint32_t)(mState.load(std::memory_order_acquire) >> 32);
+        if (generation != lastGeneration)
+        {
+            lastGeneration = generation;
+            int finished = runJobs(generation, true);
+            if (finished > 0)
+            {
+                mFinishedJobs.fetch_add(finished, std::memory_order_acq_rel);
+            }
+            continue;
+        }
+
+        // --- nothing new, sleep until run() or stop() signals, or the timeout when the signal was missed
+        std::unique_lock<std::mutex> lock(mMutex);
+        mNumSleeping.fetch_add(1, std::memory_order_seq_cst);
+        if ((uint32_t)(mState.load(std::memory_order_seq_cst) >> 32) == lastGeneration && !mQuit)
+        {
+            mWake.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        mNumSleeping.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+inline int64_t WorkerPool::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif /* WorkerPool_h */
@@ -0,0 +1,463 @@
+//
+//  Benchmark.cpp
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#include "Benchmark.h"
+#include "../../Source/PluginProcessor.h"
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+namespace
+{
+    const double sampleRates[] = { 44100, 48000, 96000 };
+    const int blockSizes[] = { 32, 128, 512, 2048 };
+    const int channelCounts[] = { 1, 2, 6 };
+
+    // --- every kernel leaves a value here, so the compiler cannot drop its work
+    volatile float sink;
+
+    void fillNoise(juce::Random& random, float* output, int numSamples)
+    {
+        for (int i = 0; i < numSamples; i++)
+        {
+            output[i] = random.nextFloat() * 2 - 1;
+        }
+    }
+}
+
+void Benchmark::setQuick(bool quick)
+{
+    mQuick = quick;
+}
+
+void Benchmark::setFilter(const juce::String& filter)
+{
+    mFilter = filter;
+}
+
+template <typename Block>
+Benchmark::Measurement Benchmark::measure(Block block, double samplesPerCall)
+{
+    // --- warm up, then double the calls per repeat until one repeat takes long enough to time
+    block();
+    int calls = 1;
+    while (true)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int call = 0; call < calls; call++)
+        {
+            block();
+        }
+        if (juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start) >= kMinimumTime)
+        {
+            break;
+        }
+        calls *= 2;
+    }
+
+    Measurement best = { std::numeric_limits<double>::max(), -1 };
+    for (int repeat = 0; repeat < kRepeats; repeat++)
+    {
+        auto startCycles = readCycleCounter();
+        auto start = juce::Time::getHighResolutionTicks();
+        for (int call = 0; call < calls; call++)
+        {
+            block();
+        }
+        auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+        auto cycles = readCycleCounter() - startCycles;
+
+        auto samples = calls * samplesPerCall;
+        if (seconds * 1e9 / samples < best.nsPerSample)
+        {
+            best.nsPerSample = seconds * 1e9 / samples;
+            best.cyclesPerSample = startCycles == 0 ? -1 : cycles / samples;
+        }
+    }
+    return best;
+}
+
+void Benchmark::run()
+{
+    mOutput << "benchmark,variant,sample_rate,block_size,channels,ns_per_sample,cycles_per_sample\n";
+
+    std::vector<Config> configs;
+    if (mQuick)
+    {
+        configs.push_back({ 48000, 512, 2 });
+    }
+    else
+    {
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto blockSize : blockSizes)
+            {
+                for (auto channels : channelCounts)
+                {
+                    configs.push_back({ sampleRate, blockSize, channels });
+                }
+            }
+        }
+    }
+
+    for (auto& config : configs)
+    {
+        runCircularBuffer(config);
+        runOscillator(config);
+        runFilterDesigner(config);
+        runParameterSmooth(config);
+        runPartitionedConvolver(config);
+        runFeedbackNetwork<4, 1>(config);
+        runFeedbackNetwork<8, 1>(config);
+        runFeedbackNetwork<16, 1>(config);
+        runFeedbackNetwork<32, 1>(config);
+        runFeedbackNetwork<4, 2>(config);
+        runFeedbackNetwork<8, 2>(config);
+        runFeedbackNetwork<16, 2>(config);
+        runFeedbackNetwork<32, 2>(config);
+        runProcessor(config);
+        mOutput.flush();
+    }
+}
+
+void Benchmark::runCircularBuffer(const Config& config)
+{
+    if (!isSelected("circular_buffer"))
+    {
+        return;
+    }
+
+    // --- modulated reads around 10 ms, like the taps of the feedback network, then the write
+    auto run = [this, &config](auto interpolation, const char* variant)
+    {
+        using Buffer = CircularBuffer<float, decltype(interpolation)>;
+        int numSamples = config.blockSize;
+        std::vector<Buffer> buffers(config.channels);
+        for (auto& buffer : buffers)
+        {
+            buffer.createCircularBuffer((unsigned int)(config.sampleRate * 0.02));
+        }
+
+        juce::Random random(1);
+        std::vector<float> input(numSamples), output(numSamples), delays(numSamples);
+        fillNoise(random, input.data(), numSamples);
+        for (int i = 0; i < numSamples; i++)
+        {
+            delays[i] = (float)(config.sampleRate * 0.01 * (1 + 0.1 * sin(TWO_PI * i / numSamples)));
+        }
+
+        auto measurement = measure([&]
+        {
+            for (auto& buffer : buffers)
+            {
+                buffer.readBlock(output.data(), delays.data(), numSamples);
+                buffer.writeBlock(input.data(), numSamples);
+            }
+            sink = output[0];
+        }, (double)numSamples * config.channels);
+        report("circular_buffer", variant, config, measurement);
+    };
+
+    run(NoInterpolation(), "none");
+    run(LinearInterpolation(), "linear");
+    run(HermiteInterpolation(), "hermite");
+    run(LagrangeInterpolation(), "lagrange");
+    run(ThiranInterpolation(), "thiran");
+}
+
+void Benchmark::runOscillator(const Config& config)
+{
+    static const char* shapes[] = { "sine", "triangle", "sawtooth", "trapezoid", "square", "phasor", "phasor_inv" };
+    int numSamples = config.blockSize;
+
+    if (isSelected("oscillator"))
+    {
+        for (int model = E_SINE; model <= E_PHASOR_INV; model++)
+        {
+            std::vector<Oscillator> oscillators(config.channels);
+            auto measurement = measure([&]
+            {
+                float value = 0;
+                for (auto& oscillator : oscillators)
+                {
+                    for (int i = 0; i < numSamples; i++)
+                    {
+                        value += (float)oscillator.process(1.0, config.sampleRate, model, 0);
+                    }
+                }
+                sink = value;
+            }, (double)numSamples * config.channels);
+            report("oscillator", shapes[model], config, measurement);
+        }
+    }
+
+    if (isSelected("wavetable_oscillator"))
+    {
+        for (int model = E_SINE; model <= E_PHASOR_INV; model++)
+        {
+            std::vector<WavetableOscillator> oscillators(config.channels);
+            for (auto& oscillator : oscillators)
+            {
+                oscillator.setShape(model);
+                oscillator.setFrequency(1.0, config.sampleRate);
+            }
+            auto measurement = measure([&]
+            {
+                float value = 0;
+                for (auto& oscillator : oscillators)
+                {
+                    for (int i = 0; i < numSamples; i++)
+                    {
+                        value += (float)oscillator.process();
+                    }
+                }
+                sink = value;
+            }, (double)numSamples * config.channels);
+            report("wavetable_oscillator", shapes[model], config, measurement);
+        }
+    }
+}
+
+void Benchmark::runFilterDesigner(const Config& config)
+{
+    if (!isSelected("filter_designer"))
+    {
+        return;
+    }
+
+    // --- one design per block and channel, the way the processor calls it, per sample of the block
+    std::vector<FilterDesigner> designers(config.channels);
+    for (auto& designer : designers)
+    {
+        designer.model = E_LOW_PASS_1;
+    }
+
+    for (int sweep = 0; sweep < 2; sweep++)
+    {
+        float cutOff = 1000;
+        auto measurement = measure([&]
+        {
+            // --- a sweep changes the cut-off on every call, a static setting hits the memo
+            cutOff = sweep == 1 ? (cutOff > 5000 ? 150 : cutOff * 1.01f) : cutOff;
+            for (auto& designer : designers)
+            {
+                designer.setParameter(cutOff, (float)config.sampleRate, 0, 0, 0);
+                sink = designer.getCoefficients()[0];
+            }
+        }, (double)config.blockSize * config.channels);
+        report("filter_designer", sweep == 1 ? "sweep" : "static", config, measurement);
+    }
+}
+
+void Benchmark::runParameterSmooth(const Config& config)
+{
+    if (!isSelected("parameter_smooth"))
+    {
+        return;
+    }
+
+    int numSamples = config.blockSize;
+    std::vector<ParameterSmooth> smoothers(config.channels);
+    for (auto& smoother : smoothers)
+    {
+        smoother.createCoefficients((float)(config.sampleRate * 0.001), (float)config.sampleRate);
+    }
+    std::vector<float> output(numSamples);
+
+    // --- a target that jumps every block keeps the smoothers moving, a fixed one lets them settle
+    for (int moving = 0; moving < 2; moving++)
+    {
+        float target = 0.25f;
+        auto measurement = measure([&]
+        {
+            target = moving == 1 ? 1 - target : target;
+            for (auto& smoother : smoothers)
+            {
+                smoother.processBlock(target, output.data(), numSamples);
+            }
+            sink = output[0];
+        }, (double)numSamples * config.channels);
+        report("parameter_smooth", moving == 1 ? "moving" : "settled", config, measurement);
+    }
+}
+
+void Benchmark::runPartitionedConvolver(const Config& config)
+{
+    if (!isSelected("partitioned_convolver"))
+    {
+        return;
+    }
+
+    int numSamples = config.blockSize;
+    juce::Random random(1);
+    std::vector<float> input(numSamples);
+    std::vector<float> output(numSamples);
+    fillNoise(random, input.data(), numSamples);
+
+    // --- responses as long as a short and a long frozen network
+    for (auto seconds : { 1, 4 })
+    {
+        auto length = (int)(seconds * config.sampleRate);
+        std::vector<float> response(length);
+        fillNoise(random, response.data(), length);
+
+        ConvolutionKernel kernel;
+        kernel.prepare(length);
+        kernel.setImpulseResponse(response.data(), length);
+        std::vector<PartitionedConvolver<1>> convolvers(config.channels);
+        for (auto& convolver : convolvers)
+        {
+            convolver.prepare(length);
+            convolver.start(&kernel);
+        }
+
+        auto measurement = measure([&]
+        {
+            const float* in = input.data();
+            float* out = output.data();
+            for (auto& convolver : convolvers)
+            {
+                convolver.process(&in, &out, numSamples);
+            }
+            sink = output[0];
+        }, (double)numSamples * config.channels);
+        report("partitioned_convolver", juce::String(seconds) + "s", config, measurement);
+    }
+}
+
+template <int N, int Lanes>
+void Benchmark::runFeedbackNetwork(const Config& config)
+{
+    if (!isSelected("fdn"))
+    {
+        return;
+    }
+
+    // --- one network per Lanes channels, at the default settings of the processor
+    using Network = FDN<N, FeedbackInterpolation, float, Lanes>;
+    int numSamples = config.blockSize;
+    int numNetworks = juce::jmax(1, config.channels / Lanes);
+    auto length = (unsigned int)ceil(Network::getMaxDelayLength(config.sampleRate) + 100 * config.sampleRate / 44100) + 3;
+    std::vector<float> memory(numNetworks * Network::getRequiredLength(length));
+    std::unique_ptr<Network[]> networks(new Network[numNetworks]);
+    for (int index = 0; index < numNetworks; index++)
+    {
+        networks[index].createFeedbackDelayNetwork(length, memory.data() + index * Network::getRequiredLength(length));
+        networks[index].setSampleRate(config.sampleRate);
+        networks[index].setControlRate(controlRate);
+        networks[index].setCoefficients(0.5f, 0.5f);
+        networks[index].setParameter(1, 40, 0.5f, 0.5f, config.sampleRate);
+    }
+
+    juce::Random random(1);
+    std::vector<float> input(Lanes * numSamples), output(Lanes * numSamples), size(numSamples, 1.0f);
+    fillNoise(random, input.data(), Lanes * numSamples);
+    const float* inputs[Lanes];
+    float* outputs[Lanes];
+    for (int lane = 0; lane < Lanes; lane++)
+    {
+        inputs[lane] = input.data() + lane * numSamples;
+        outputs[lane] = output.data() + lane * numSamples;
+    }
+
+    for (int block = 0; block < 2; block++)
+    {
+        auto measurement = measure([&]
+        {
+            for (int index = 0; index < numNetworks; index++)
+            {
+                if (block == 1)
+                {
+                    networks[index].processBlock(inputs, outputs, size.data(), numSamples);
+                    continue;
+                }
+                for (int i = 0; i < numSamples; i++)
+                {
+                    float in[Lanes];
+                    float out[Lanes];
+                    for (int lane = 0; lane < Lanes; lane++)
+                    {
+                        in[lane] = inputs[lane][i];
+                    }
+                    networks[index].processSample(in, out, 1.0f);
+                    for (int lane = 0; lane < Lanes; lane++)
+                    {
+                        outputs[lane][i] = out[lane];
+                    }
+                }
+            }
+            sink = output[0];
+        }, (double)numSamples * numNetworks * Lanes);
+        report("fdn", juce::String(N) + "_lines_" + juce::String(Lanes) + (Lanes == 1 ? "_lane_" : "_lanes_") + (block == 1 ? "block" : "sample"), config, measurement);
+    }
+}
+
+void Benchmark::runProcessor(const Config& config)
+{
+    if (!isSelected("processor"))
+    {
+        return;
+    }
+
+    juce::AudioBuffer<float> input(config.channels, config.blockSize);
+    juce::AudioBuffer<float> buffer(config.channels, config.blockSize);
+    juce::MidiBuffer midi;
+    juce::Random random(1);
+    for (int channel = 0; channel < config.channels; channel++)
+    {
+        fillNoise(random, input.getWritePointer(channel), config.blockSize);
+    }
+
+    // --- the default engine, then the one with the absorption shelves
+    for (bool absorption : { false, true })
+    {
+        PuannhiAudioProcessor processor;
+        PuannhiAudioProcessor::EngineOptions engine;
+        engine.absorptionFilters = absorption;
+        processor.setEngineOptions(engine);
+        processor.setPlayConfigDetails(config.channels, config.channels, config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+
+        auto measurement = measure([&]
+        {
+            buffer.makeCopyOf(input, true);
+            processor.processBlock(buffer, midi);
+            sink = buffer.getSample(0, 0);
+        }, (double)config.blockSize * config.channels);
+        report("processor", absorption ? "process_block_absorption" : "process_block", config, measurement);
+
+        processor.releaseResources();
+    }
+}
+
+bool Benchmark::isSelected(const juce::String& benchmark)
+{
+    return mFilter.isEmpty() || benchmark.contains(mFilter);
+}
+
+void Benchmark::report(const juce::String& benchmark, const juce::String& variant, const Config& config, const Measurement& measurement)
+{
+    mOutput << benchmark << "," << variant << ","
+            << (int)config.sampleRate << "," << config.blockSize << "," << config.channels << ","
+            << juce::String(measurement.nsPerSample, 3) << ","
+            << (measurement.cyclesPerSample < 0 ? juce::String() : juce::String(measurement.cyclesPerSample, 2)) << "\n";
+}
+
+uint64_t Benchmark::readCycleCounter()
+{
+   #if JUCE_INTEL
+    return __rdtsc();
+   #else
+    return 0;
+   #endif
+}
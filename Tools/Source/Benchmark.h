@@ -0,0 +1,86 @@
+//
+//  Benchmark.h
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef Benchmark_h
+#define Benchmark_h
+
+#include <JuceHeader.h>
+#include <ostream>
+
+// Headless timing of the DSP kernels and of the whole processor, no host and no audio device.
+// Every kernel runs over the same grid of sample rates, block sizes and channel counts, and
+// every measurement becomes one CSV line:
+//
+//     benchmark,variant,sample_rate,block_size,channels,ns_per_sample,cycles_per_sample
+//
+// Times are per sample and channel, the best of a few repeats, so the numbers stay comparable
+// between runs on a loaded machine. Cycles are time stamp counter ticks, which run at the
+// nominal clock of the CPU, and are left empty where there is no such counter.
+class Benchmark
+{
+
+public:
+    Benchmark(std::ostream& output)
+        : mOutput(output)
+    {
+        mQuick = false;
+    };
+
+    ~Benchmark()
+    {
+    };
+
+    // --- one configuration per kernel instead of the whole grid
+    void setQuick(bool quick);
+    // --- only benchmarks whose name contains filter
+    void setFilter(const juce::String& filter);
+    void run();
+
+private:
+    struct Config
+    {
+        double sampleRate;
+        int blockSize;
+        int channels;
+    };
+
+    struct Measurement
+    {
+        double nsPerSample;
+        double cyclesPerSample;
+    };
+
+    void runCircularBuffer(const Config& config);
+    void runOscillator(const Config& config);
+    void runFilterDesigner(const Config& config);
+    void runParameterSmooth(const Config& config);
+    void runPartitionedConvolver(const Config& config);
+    // --- N lines, Lanes lanes per network, sample by sample and block-wise
+    template <int N, int Lanes>
+    void runFeedbackNetwork(const Config& config);
+    void runProcessor(const Config& config);
+
+    bool isSelected(const juce::String& benchmark);
+    void report(const juce::String& benchmark, const juce::String& variant, const Config& config, const Measurement& measurement);
+
+    // --- times block() until about kMinimumTime has passed, repeated kRepeats times, and
+    // --- divides the best repeat by the samples one call of block() processes
+    template <typename Block>
+    Measurement measure(Block block, double samplesPerCall);
+
+    static uint64_t readCycleCounter();
+
+    static const int kRepeats = 5;
+    static constexpr double kMinimumTime = 0.02;
+
+    std::ostream& mOutput;
+    bool mQuick;
+    juce::String mFilter;
+};
+
+#endif /* Benchmark_h */
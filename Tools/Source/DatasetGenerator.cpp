@@ -0,0 +1,356 @@
+//
+//  DatasetGenerator.cpp
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#include "DatasetGenerator.h"
+#include "OfflineProcessor.h"
+
+void DatasetGenerator::setSampleRate(double sampleRate)
+{
+    mSampleRate = sampleRate;
+}
+
+void DatasetGenerator::setNumChannels(int numChannels)
+{
+    mNumChannels = juce::jmax(1, numChannels);
+}
+
+void DatasetGenerator::setLength(double seconds)
+{
+    mLength = seconds;
+}
+
+void DatasetGenerator::setNumJobs(int numJobs)
+{
+    mNumJobs = juce::jmax(1, numJobs);
+}
+
+void DatasetGenerator::setCache(ResponseCache* cache)
+{
+    mCache = cache;
+}
+
+bool DatasetGenerator::isParameter(const juce::String& name)
+{
+    return OfflineProcessor::getParameterNames().contains(name) && !mNames.contains(name);
+}
+
+bool DatasetGenerator::addAxis(const juce::String& axis)
+{
+    auto name = axis.upToFirstOccurrenceOf("=", false, false).trim();
+    auto values = axis.fromFirstOccurrenceOf("=", false, false);
+    if (!mPoints.empty() || !isParameter(name))
+    {
+        return false;
+    }
+
+    std::vector<float> axisValues;
+    if (values.contains(":"))
+    {
+        auto range = juce::StringArray::fromTokens(values, ":", "");
+        auto count = range[2].getIntValue();
+        if (range.size() != 3 || count < 1)
+        {
+            return false;
+        }
+        auto start = range[0].getFloatValue();
+        auto end = range[1].getFloatValue();
+        for (int index = 0; index < count; index++)
+        {
+            axisValues.push_back(count == 1 ? start : start + (end - start) * index / (count - 1));
+        }
+    }
+    else
+    {
+        for (auto& value : juce::StringArray::fromTokens(values, "/", ""))
+        {
+            axisValues.push_back(value.getFloatValue());
+        }
+    }
+    if (axisValues.empty())
+    {
+        return false;
+    }
+
+    mNames.add(name);
+    mAxes.push_back(axisValues);
+    return true;
+}
+
+bool DatasetGenerator::addPoints(const juce::File& file)
+{
+    juce::StringArray lines;
+    file.readLines(lines);
+    lines.removeEmptyStrings();
+    if (!mAxes.empty() || !mNames.isEmpty() || lines.isEmpty())
+    {
+        return false;
+    }
+
+    for (auto& name : juce::StringArray::fromTokens(lines[0], ",", ""))
+    {
+        if (!isParameter(name.trim()))
+        {
+            return false;
+        }
+        mNames.add(name.trim());
+    }
+    for (int line = 1; line < lines.size(); line++)
+    {
+        auto values = juce::StringArray::fromTokens(lines[line], ",", "");
+        if (values.size() != mNames.size())
+        {
+            return false;
+        }
+        std::vector<float> point;
+        for (auto& value : values)
+        {
+            point.push_back(value.getFloatValue());
+        }
+        mPoints.push_back(point);
+    }
+    return true;
+}
+
+std::vector<std::vector<float>> DatasetGenerator::getPoints()
+{
+    OfflineProcessor processor(mSampleRate, mNumChannels, kBlockSize);
+
+    // --- the listed points, or every combination of the axes with the last axis changing fastest
+    auto points = mPoints;
+    if (points.empty())
+    {
+        size_t numPoints = 1;
+        for (auto& axis : mAxes)
+        {
+            numPoints *= axis.size();
+        }
+        for (size_t point = 0; point < numPoints; point++)
+        {
+            std::vector<float> values(mAxes.size());
+            auto rest = point;
+            for (size_t axis = mAxes.size(); axis-- > 0; )
+            {
+                values[axis] = mAxes[axis][rest % mAxes[axis].size()];
+                rest /= mAxes[axis].size();
+            }
+            points.push_back(values);
+        }
+    }
+
+    // --- every parameter of the processor, in its order, as the processor took the values:
+    // --- clamped to their ranges and rounded, the rest at their defaults
+    std::vector<std::vector<float>> fullPoints;
+    for (auto& point : points)
+    {
+        for (int index = 0; index < mNames.size(); index++)
+        {
+            processor.setParameter(mNames[index], point[index]);
+        }
+        fullPoints.push_back(processor.getParameters());
+    }
+    return fullPoints;
+}
+
+bool DatasetGenerator::generate(const juce::File& file)
+{
+    auto names = OfflineProcessor::getParameterNames();
+    auto points = getPoints();
+    auto numPoints = (int)points.size();
+    auto length = juce::jmax(1, (int)(mLength * mSampleRate));
+
+    // --- header, names and table through a stream, then the file grows to its full size for the records
+    file.deleteFile();
+    juce::int64 tableOffset = 0;
+    juce::int64 recordsOffset = 0;
+    juce::int64 recordSize = (juce::int64)mNumChannels * length * sizeof(float);
+    {
+        juce::FileOutputStream stream(file);
+        if (stream.failedToOpen())
+        {
+            return false;
+        }
+        stream.write("PIRS", 4);
+        stream.writeInt(kVersion);
+        stream.writeInt(numPoints);
+        stream.writeInt(names.size());
+        stream.writeInt(mNumChannels);
+        stream.writeInt(length);
+        stream.writeDouble(mSampleRate);
+        for (auto& name : names)
+        {
+            char padded[kNameSize] = {};
+            name.copyToUTF8(padded, kNameSize - 1);
+            stream.write(padded, kNameSize);
+        }
+        tableOffset = stream.getPosition();
+        for (auto& point : points)
+        {
+            for (auto value : point)
+            {
+                stream.writeFloat(value);
+            }
+        }
+
+        recordsOffset = stream.getPosition();
+        auto size = recordsOffset + numPoints * recordSize;
+        if (size > recordsOffset)
+        {
+            stream.setPosition(size - 1);
+            stream.writeByte(0);
+        }
+        stream.flush();
+        if (stream.getStatus().failed())
+        {
+            return false;
+        }
+    }
+
+    juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readWrite);
+    if (numPoints > 0 && mapped.getData() == nullptr)
+    {
+        return false;
+    }
+    auto* table = reinterpret_cast<float*>(static_cast<char*>(mapped.getData()) + tableOffset);
+    auto* records = static_cast<char*>(mapped.getData()) + recordsOffset;
+
+    // --- even ranges to start with, the stealing evens out the rest
+    auto numWorkers = juce::jmax(1, juce::jmin(mNumJobs, numPoints));
+    mRanges.reset(new Range[numWorkers]);
+    for (int worker = 0; worker < numWorkers; worker++)
+    {
+        mRanges[worker].bounds = pack((uint32_t)((juce::int64)numPoints * worker / numWorkers), (uint32_t)((juce::int64)numPoints * (worker + 1) / numWorkers));
+    }
+    mFinished = 0;
+
+    auto start = juce::Time::getHighResolutionTicks();
+    std::vector<std::thread> workers;
+    for (int worker = 1; worker < numWorkers; worker++)
+    {
+        workers.emplace_back([this, worker, table, records, &points] { work(worker, table, records, points); });
+    }
+    work(0, table, records, points);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    mOutput << numPoints << " responses of " << length << " samples in " << juce::String(seconds, 1)
+            << " s, " << juce::String(numPoints / juce::jmax(seconds, 1e-9), 1) << " per second";
+    if (mCache != nullptr)
+    {
+        mOutput << ", " << mCache->getNumHits() << " from the cache";
+    }
+    mOutput << std::endl;
+    return mFinished == numPoints;
+}
+
+void DatasetGenerator::work(int worker, float* table, char* records, const std::vector<std::vector<float>>& points)
+{
+    auto names = OfflineProcessor::getParameterNames();
+    auto length = juce::jmax(1, (int)(mLength * mSampleRate));
+    auto numWorkers = juce::jmin(mNumJobs, (int)points.size());
+    OfflineProcessor processor(mSampleRate, mNumChannels, kBlockSize);
+    juce::AudioBuffer<float> buffer(mNumChannels, length);
+
+    while (true)
+    {
+        int point;
+        if (!take(mRanges[worker], point))
+        {
+            // --- look at every other worker once, starting with the next one, and stop when all are empty
+            bool stolen = false;
+            for (int offset = 1; offset < numWorkers && !stolen; offset++)
+            {
+                stolen = steal(mRanges[(worker + offset) % numWorkers], mRanges[worker]);
+            }
+            if (!stolen)
+            {
+                return;
+            }
+            continue;
+        }
+
+        // --- the row of the table holds the values the processor renders with, should setting
+        // --- them again have moved one by a rounding step
+        for (int index = 0; index < names.size(); index++)
+        {
+            processor.setParameter(names[index], points[point][index]);
+        }
+        auto values = processor.getParameters();
+        memcpy(table + (juce::int64)point * names.size(), values.data(), values.size() * sizeof(float));
+
+        // --- a cached response is copied straight from its mapping, the rest is rendered and cached.
+        // --- The key is made of the values the processor took, like the one of the response command
+        auto key = ResponseCache::getKey(names, values, mSampleRate, mNumChannels, length, processor.getConfiguration());
+        auto cached = mCache != nullptr ? mCache->find(key) : nullptr;
+        if (cached == nullptr)
+        {
+            processor.renderImpulseResponse(buffer);
+            if (mCache != nullptr)
+            {
+                mCache->store(key, buffer.getArrayOfReadPointers(), mNumChannels, length);
+            }
+        }
+
+        auto* record = reinterpret_cast<float*>(records + (juce::int64)point * mNumChannels * length * sizeof(float));
+        for (int channel = 0; channel < mNumChannels; channel++)
+        {
+            // --- the file is little-endian, like every machine this builds for
+            auto* samples = cached != nullptr ? cached->getReadPointer(channel) : buffer.getReadPointer(channel);
+            memcpy(record + (juce::int64)channel * length, samples, length * sizeof(float));
+        }
+        mFinished++;
+    }
+}
+
+bool DatasetGenerator::take(Range& range, int& point)
+{
+    auto bounds = range.bounds.load(std::memory_order_acquire);
+    while (true)
+    {
+        auto begin = (uint32_t)bounds;
+        auto end = (uint32_t)(bounds >> 32);
+        if (begin >= end)
+        {
+            return false;
+        }
+        if (range.bounds.compare_exchange_weak(bounds, pack(begin + 1, end), std::memory_order_acq_rel))
+        {
+            point = (int)begin;
+            return true;
+        }
+    }
+}
+
+bool DatasetGenerator::steal(Range& victim, Range& range)
+{
+    auto bounds = victim.bounds.load(std::memory_order_acquire);
+    while (true)
+    {
+        auto begin = (uint32_t)bounds;
+        auto end = (uint32_t)(bounds >> 32);
+        if (begin >= end)
+        {
+            return false;
+        }
+        // --- the victim keeps the front half, which it is working through
+        auto middle = begin + (end - begin) / 2;
+        if (victim.bounds.compare_exchange_weak(bounds, pack(begin, middle), std::memory_order_acq_rel))
+        {
+            // --- the own range is empty, so no one else changes it, thieves only ever shrink a range
+            range.bounds.store(pack(middle, end), std::memory_order_release);
+            return true;
+        }
+    }
+}
+
+uint64_t DatasetGenerator::pack(uint32_t begin, uint32_t end)
+{
+    return (uint64_t)end << 32 | begin;
+}
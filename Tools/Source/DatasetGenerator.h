@@ -0,0 +1,115 @@
+//
+//  DatasetGenerator.h
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef DatasetGenerator_h
+#define DatasetGenerator_h
+
+#include <JuceHeader.h>
+#include "ResponseCache.h"
+#include <atomic>
+#include <ostream>
+
+// Renders the impulse response of the processor for every point of a parameter grid, or of a
+// list of points, into one file. The points are split into one contiguous range per worker.
+// Each worker renders with its own processor, from the front of its range, and once its range
+// is empty it steals the back half of another worker's range, so a few slow points do not
+// leave the other cores idle at the end.
+//
+// Every response has the same length, so the file is a header and a table followed by records
+// of one size, and response i sits at a fixed offset. All numbers are little-endian:
+//
+//     char[4]   "PIRS"
+//     int32     version, 1
+//     int32     number of points
+//     int32     number of parameters
+//     int32     number of channels
+//     int32     samples per channel
+//     float64   sample rate
+//     char[32]  name of every parameter, zero padded
+//     float32   value of every parameter of every point, point by point, as the processor
+//               rendered it: clamped to the range of the parameter and rounded like a host sees it
+//     float32   samples of every channel of every point, point by point, channel by channel
+//
+// The workers write their records straight into the file mapped into memory, in any order.
+class DatasetGenerator
+{
+
+public:
+    DatasetGenerator(std::ostream& output)
+        : mOutput(output)
+    {
+        mSampleRate = 48000;
+        mNumChannels = 2;
+        mLength = 1;
+        mNumJobs = juce::jmax(1, (int)std::thread::hardware_concurrency());
+        mCache = nullptr;
+    };
+
+    ~DatasetGenerator()
+    {
+    };
+
+    void setSampleRate(double sampleRate);
+    void setNumChannels(int numChannels);
+    // --- of every response, in seconds
+    void setLength(double seconds);
+    void setNumJobs(int numJobs);
+    // --- responses found there are not rendered again, and rendered ones are added, nullptr for none
+    void setCache(ResponseCache* cache);
+
+    // --- one axis of the grid, "Name=start:end:count" for evenly spaced values or
+    // --- "Name=a/b/c" for the values given, returns false when it does not parse
+    bool addAxis(const juce::String& axis);
+    // --- points instead of a grid, CSV with the parameter names in the first line and one
+    // --- point per line after it, returns false when it does not parse
+    bool addPoints(const juce::File& file);
+
+    // --- parameters missing from the grid or the points keep their defaults, values outside
+    // --- the range of a parameter are clamped to it, in the table as in the audio
+    bool generate(const juce::File& file);
+
+    static const int kVersion = 1;
+    static const int kNameSize = 32;
+    static const int kBlockSize = 512;
+
+private:
+    // --- the range of points a worker has left, begin in the lower and end in the upper half
+    struct alignas(64) Range
+    {
+        std::atomic<uint64_t> bounds { 0 };
+    };
+
+    bool isParameter(const juce::String& name);
+    std::vector<std::vector<float>> getPoints();
+    // --- renders points into records and writes the values they rendered with into table
+    void work(int worker, float* table, char* records, const std::vector<std::vector<float>>& points);
+    // --- takes the first point of the own range, returns false when it is empty
+    bool take(Range& range, int& point);
+    // --- moves the back half of the victim's range into the own empty range
+    bool steal(Range& victim, Range& range);
+
+    static uint64_t pack(uint32_t begin, uint32_t end);
+
+    std::ostream& mOutput;
+    double mSampleRate;
+    int mNumChannels;
+    double mLength;
+    int mNumJobs;
+    ResponseCache* mCache;
+
+    juce::StringArray mNames;
+    // --- values of every axis, in the order of mNames
+    std::vector<std::vector<float>> mAxes;
+    // --- or the points of a list, one value per name
+    std::vector<std::vector<float>> mPoints;
+
+    std::unique_ptr<Range[]> mRanges;
+    std::atomic<int> mFinished { 0 };
+};
+
+#endif /* DatasetGenerator_h */
@@ -0,0 +1,324 @@
+//
+//  GoldenCheck.cpp
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#include "GoldenCheck.h"
+
+namespace
+{
+    const double sampleRates[] = { 44100, 48000, 96000 };
+    const int numChannels = 2;
+    const int blockSize = 512;
+    const double renderTime = 2;
+    const double burstTime = 0.05;
+}
+
+void GoldenCheck::setQuick(bool quick)
+{
+    mQuick = quick;
+}
+
+void GoldenCheck::setExact(bool exact)
+{
+    mExact = exact;
+}
+
+void GoldenCheck::setMaxError(double maxError)
+{
+    mMaxError = maxError;
+}
+
+void GoldenCheck::setMaxEnvelopeDeviation(double decibels)
+{
+    mMaxEnvelopeDeviation = decibels;
+}
+
+std::vector<GoldenCheck::Case> GoldenCheck::getCases()
+{
+    // --- the defaults and the corners of the ranges
+    static const OfflineProcessor::Preset presets[] =
+    {
+        { "default",     { { "Mixing", 0.5f }, { "Pre-Delay",   0 }, { "Brightness", 1000 }, { "Damping", 0.5f }, { "Decay", 0.5f }, { "Size",     1 }, { "Speed",    1 }, { "Depth",  40 } } },
+        { "bright_long", { { "Mixing",    1 }, { "Pre-Delay",  37 }, { "Brightness", 3000 }, { "Damping", 0.2f }, { "Decay", 0.9f }, { "Size",  0.5f }, { "Speed", 2.5f }, { "Depth",  80 } } },
+        { "dark_short",  { { "Mixing", 0.3f }, { "Pre-Delay", 150 }, { "Brightness",  300 }, { "Damping", 0.9f }, { "Decay", 0.1f }, { "Size", 0.05f }, { "Speed", 0.3f }, { "Depth",   5 } } },
+        { "extreme",     { { "Mixing", 0.7f }, { "Pre-Delay",  10 }, { "Brightness", 5000 }, { "Damping",    0 }, { "Decay",    1 }, { "Size", 0.01f }, { "Speed",    4 }, { "Depth", 100 } } },
+    };
+
+    std::vector<Case> cases;
+    for (auto& preset : presets)
+    {
+        for (auto sampleRate : sampleRates)
+        {
+            if (mQuick && sampleRate != 48000)
+            {
+                continue;
+            }
+            for (bool noise : { false, true })
+            {
+                auto name = juce::String(preset.name) + "_" + juce::String((int)sampleRate) + (noise ? "_noise" : "_impulse");
+                cases.push_back({ name, &preset, sampleRate, noise, {} });
+            }
+        }
+    }
+
+    // --- the engine options the processor can run with besides its defaults, by case suffix
+    std::vector<std::pair<juce::String, PuannhiAudioProcessor::EngineOptions>> engines;
+    PuannhiAudioProcessor::EngineOptions engine;
+    engine.blockProcessing = false;
+    engines.push_back({ "sample_processing", engine });
+    engine = {};
+    engine.controlRate = 1;
+    engines.push_back({ "control_rate_1", engine });
+    engine = {};
+    engine.absorptionFilters = true;
+    engines.push_back({ "absorption", engine });
+    engine = {};
+    engine.feedbackStorage = E_HALF_FLOAT_STORAGE;
+    engines.push_back({ "half_float", engine });
+    engine = {};
+    engine.feedbackStorage = E_DITHERED_INT16_STORAGE;
+    engines.push_back({ "dithered_int16", engine });
+
+    for (auto& engine : engines)
+    {
+        for (auto& preset : presets)
+        {
+            for (bool noise : { false, true })
+            {
+                auto name = juce::String(preset.name) + "_48000" + (noise ? "_noise_" : "_impulse_") + engine.first;
+                cases.push_back({ name, &preset, 48000, noise, engine.second });
+            }
+        }
+    }
+    return cases;
+}
+
+juce::AudioBuffer<float> GoldenCheck::render(const Case& testCase)
+{
+    OfflineProcessor processor(testCase.sampleRate, numChannels, blockSize, testCase.engine);
+    if (!processor.setParameters(*testCase.preset))
+    {
+        return {};
+    }
+    // --- every case starts from cleared lines and smoothers, whatever ran before it
+    processor.reset();
+
+    juce::AudioBuffer<float> buffer(numChannels, (int)(testCase.sampleRate * renderTime));
+    buffer.clear();
+    if (testCase.noise)
+    {
+        juce::Random random(1);
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            for (int i = 0; i < (int)(testCase.sampleRate * burstTime); i++)
+            {
+                buffer.setSample(channel, i, random.nextFloat() * 2 - 1);
+            }
+        }
+    }
+    else
+    {
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            buffer.setSample(channel, 0, 1);
+        }
+    }
+
+    processor.process(buffer);
+    return buffer;
+}
+
+bool GoldenCheck::write(const juce::File& folder)
+{
+    if (!folder.createDirectory())
+    {
+        return false;
+    }
+
+    juce::WavAudioFormat format;
+    for (auto& testCase : getCases())
+    {
+        auto buffer = render(testCase);
+        if (buffer.getNumChannels() == 0)
+        {
+            mOutput << testCase.name << ", unknown parameter" << std::endl;
+            return false;
+        }
+        auto file = folder.getChildFile(testCase.name + ".wav");
+        file.deleteFile();
+
+        std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+        if (stream == nullptr)
+        {
+            return false;
+        }
+        std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(stream.get(), testCase.sampleRate, (unsigned int)numChannels, 32, {}, 0));
+        if (writer == nullptr)
+        {
+            return false;
+        }
+        // --- the writer owns the stream from here on
+        stream.release();
+        if (!writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples()))
+        {
+            return false;
+        }
+        mOutput << testCase.name << std::endl;
+    }
+    return true;
+}
+
+int GoldenCheck::verify(const juce::File& folder)
+{
+    juce::WavAudioFormat format;
+    int failures = 0;
+    mOutput << "case,result,bit_exact,max_error,envelope_deviation_db" << std::endl;
+    for (auto& testCase : getCases())
+    {
+        auto file = folder.getChildFile(testCase.name + ".wav");
+        std::unique_ptr<juce::AudioFormatReader> reader;
+        if (file.existsAsFile())
+        {
+            reader.reset(format.createReaderFor(file.createInputStream().release(), true));
+        }
+
+        auto test = render(testCase);
+        if (test.getNumChannels() == 0)
+        {
+            mOutput << testCase.name << ",fail,,," << std::endl;
+            failures++;
+            continue;
+        }
+        if (reader == nullptr
+            || reader->sampleRate != testCase.sampleRate
+            || (int)reader->numChannels != test.getNumChannels()
+            || (int)reader->lengthInSamples != test.getNumSamples())
+        {
+            mOutput << testCase.name << ",missing,,," << std::endl;
+            failures++;
+            continue;
+        }
+
+        juce::AudioBuffer<float> reference(test.getNumChannels(), test.getNumSamples());
+        reader->read(&reference, 0, reference.getNumSamples(), 0, true, true);
+
+        auto maxError = getMaxError(reference, test);
+        auto deviation = getEnvelopeDeviation(reference, test, testCase.sampleRate);
+        bool exact = maxError == 0;
+        bool passed = exact;
+        if (!mExact)
+        {
+            passed = (mMaxError < 0 || maxError <= mMaxError) && deviation <= mMaxEnvelopeDeviation;
+        }
+        if (!passed)
+        {
+            failures++;
+        }
+
+        mOutput << testCase.name << ","
+                << (passed ? "pass" : "fail") << ","
+                << (exact ? "yes" : "no") << ","
+                << maxError << ","
+                << deviation << std::endl;
+    }
+    return failures;
+}
+
+double GoldenCheck::getMaxError(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& test)
+{
+    double maxError = 0;
+    for (int channel = 0; channel < reference.getNumChannels(); channel++)
+    {
+        auto* a = reference.getReadPointer(channel);
+        auto* b = test.getReadPointer(channel);
+        for (int i = 0; i < reference.getNumSamples(); i++)
+        {
+            maxError = juce::jmax(maxError, (double)std::abs(a[i] - b[i]));
+        }
+    }
+    return maxError;
+}
+
+double GoldenCheck::getEnvelopeDeviation(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& test, double sampleRate)
+{
+    auto referenceEnergies = getBandEnergies(reference, sampleRate);
+    auto testEnergies = getBandEnergies(test, sampleRate);
+
+    double peak = 0;
+    for (auto energy : referenceEnergies)
+    {
+        peak = juce::jmax(peak, energy);
+    }
+    // --- bands far below the loudest one are the noise floor of the tail, where any change
+    // --- of the modulation reads as a large deviation
+    double floor = peak * std::pow(10.0, -kEnvelopeRange / 10);
+
+    double deviation = 0;
+    for (size_t i = 0; i < referenceEnergies.size(); i++)
+    {
+        if (referenceEnergies[i] > floor && referenceEnergies[i] > 0)
+        {
+            auto ratio = juce::jmax(testEnergies[i], floor) / referenceEnergies[i];
+            deviation = juce::jmax(deviation, std::abs(10 * std::log10(ratio)));
+        }
+    }
+    return deviation;
+}
+
+std::vector<double> GoldenCheck::getBandEnergies(const juce::AudioBuffer<float>& buffer, double sampleRate)
+{
+    const int frameSize = 1 << kFrameOrder;
+    juce::dsp::FFT fft(kFrameOrder);
+    juce::dsp::WindowingFunction<float> window((size_t)frameSize, juce::dsp::WindowingFunction<float>::hann, false);
+
+    // --- third-octave bands around 1 kHz from 25 Hz up to the Nyquist frequency, as bin ranges,
+    // --- merged into the next band while they are narrower than one bin
+    std::vector<int> edges;
+    for (int band = -16; ; band++)
+    {
+        auto edge = 1000 * std::pow(2.0, (band - 0.5) / 3);
+        if (edge >= sampleRate / 2)
+        {
+            break;
+        }
+        auto bin = (int)std::ceil(edge * frameSize / sampleRate);
+        if (edges.empty() || bin > edges.back())
+        {
+            edges.push_back(bin);
+        }
+    }
+    edges.push_back(frameSize / 2);
+
+    // --- half-overlapping frames, summed over both channels and over kSegmentFrames frames, so
+    // --- the envelope follows the decay without the frame to frame scatter of a noisy tail
+    auto numBands = edges.size() - 1;
+    auto numFrames = (buffer.getNumSamples() - frameSize) / (frameSize / 2) + 1;
+    std::vector<double> energies(((numFrames + kSegmentFrames - 1) / kSegmentFrames) * numBands, 0.0);
+    std::vector<float> frame(frameSize * 2);
+    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+    {
+        auto* input = buffer.getReadPointer(channel);
+        for (int index = 0; index < numFrames; index++)
+        {
+            auto* start = input + index * (frameSize / 2);
+            std::fill(frame.begin(), frame.end(), 0.0f);
+            std::copy(start, start + frameSize, frame.begin());
+            window.multiplyWithWindowingTable(frame.data(), (size_t)frameSize);
+            fft.performFrequencyOnlyForwardTransform(frame.data());
+
+            auto* segment = &energies[(index / kSegmentFrames) * numBands];
+            for (size_t band = 0; band < numBands; band++)
+            {
+                for (int bin = edges[band]; bin < edges[band + 1]; bin++)
+                {
+                    segment[band] += (double)frame[bin] * frame[bin];
+                }
+            }
+        }
+    }
+    return energies;
+}
@@ -0,0 +1,89 @@
+//
+//  GoldenCheck.h
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef GoldenCheck_h
+#define GoldenCheck_h
+
+#include <JuceHeader.h>
+#include <ostream>
+#include "OfflineProcessor.h"
+
+// Regression check of the processor against stored renders. write() renders every case of a
+// fixed grid, parameter presets by sample rates by stimuli, plus every preset at 48 kHz on each
+// engine other than the default one, into a folder of 32-bit float WAV
+// files, and verify() renders the same cases with the current build and compares them with
+// those files, one CSV line per case:
+//
+//     case,result,bit_exact,max_error,envelope_deviation_db
+//
+// A case passes when it is bit-exact or, unless setExact() asks for bit-exactness, when both
+// tolerances hold: the largest absolute difference of any sample, and the largest deviation of
+// the spectral envelope, the third-octave band energies of consecutive stretches of about a
+// fifth of a second in dB, over every band of the reference within kEnvelopeRange dB of its
+// loudest one. The sample difference is only checked when setMaxError() was given a
+// tolerance, since a change of the modulation alone moves the samples a lot without changing
+// how the response sounds.
+class GoldenCheck
+{
+
+public:
+    GoldenCheck(std::ostream& output)
+        : mOutput(output)
+    {
+        mQuick = false;
+        mExact = false;
+        mMaxError = -1;
+        mMaxEnvelopeDeviation = 3;
+    };
+
+    ~GoldenCheck()
+    {
+    };
+
+    // --- one sample rate instead of all of them
+    void setQuick(bool quick);
+    void setExact(bool exact);
+    // --- negative to leave the sample difference unchecked
+    void setMaxError(double maxError);
+    void setMaxEnvelopeDeviation(double decibels);
+
+    bool write(const juce::File& folder);
+    // --- returns the number of cases that failed or had no reference
+    int verify(const juce::File& folder);
+
+    static const int kFrameOrder = 11;
+    static const int kSegmentFrames = 8;
+    static constexpr double kEnvelopeRange = 60;
+
+private:
+    struct Case
+    {
+        juce::String name;
+        const OfflineProcessor::Preset* preset;
+        double sampleRate;
+        bool noise;
+        PuannhiAudioProcessor::EngineOptions engine;
+    };
+
+    std::vector<Case> getCases();
+    // --- an empty buffer when the preset names an unknown parameter
+    juce::AudioBuffer<float> render(const Case& testCase);
+
+    static double getMaxError(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& test);
+    static double getEnvelopeDeviation(const juce::AudioBuffer<float>& reference, const juce::AudioBuffer<float>& test, double sampleRate);
+    // --- band energies of every stretch, one after the other
+    static std::vector<double> getBandEnergies(const juce::AudioBuffer<float>& buffer, double sampleRate);
+
+    std::ostream& mOutput;
+    bool mQuick;
+    bool mExact;
+    double mMaxError;
+    double mMaxEnvelopeDeviation;
+};
+
+#endif /* GoldenCheck_h */
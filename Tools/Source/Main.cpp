@@ -0,0 +1,306 @@
+//
+//  Main.cpp
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#include <JuceHeader.h>
+#include "Benchmark.h"
+#include "DatasetGenerator.h"
+#include "GoldenCheck.h"
+#include "OfflineProcessor.h"
+#include "OfflineRenderer.h"
+#include "ResponseCache.h"
+#include "StorageCheck.h"
+#include <fstream>
+#include <iostream>
+
+// --- the pairs of --parameters=Name=value,..., fails on names the processor does not have
+static std::vector<std::pair<juce::String, float>> getParameters(const juce::ArgumentList& args)
+{
+    auto names = OfflineProcessor::getParameterNames();
+    std::vector<std::pair<juce::String, float>> parameters;
+    for (auto& parameter : juce::StringArray::fromTokens(args.getValueForOption("--parameters"), ",", ""))
+    {
+        auto name = parameter.upToFirstOccurrenceOf("=", false, false).trim();
+        if (!names.contains(name))
+        {
+            juce::ConsoleApplication::fail("Unknown parameter " + name + ", expected one of " + names.joinIntoString(", "));
+        }
+        parameters.push_back({ name, parameter.fromFirstOccurrenceOf("=", false, false).getFloatValue() });
+    }
+    return parameters;
+}
+
+// --- the folder of --cache held to --cache-size MB, 1024 by default, nullptr without --cache
+static std::unique_ptr<ResponseCache> createCache(const juce::ArgumentList& args)
+{
+    if (!args.containsOption("--cache"))
+    {
+        return nullptr;
+    }
+    auto megabytes = args.containsOption("--cache-size") ? args.getValueForOption("--cache-size").getLargeIntValue() : 1024;
+    auto folder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--cache"));
+    return std::unique_ptr<ResponseCache>(new ResponseCache(folder, megabytes * 1024 * 1024));
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ConsoleApplication app;
+    app.addHelpCommand("--help|-h", "Usage: PuannhiTools <command> [options]", true);
+
+    app.addCommand({ "bench",
+                     "bench [--quick] [--filter=name] [--output=file.csv]",
+                     "Times the DSP kernels and the processor, one CSV line per measurement.",
+                     "Runs every kernel over sample rates, block sizes and channel counts and prints ns and\n"
+                     "cycles per sample and channel. --quick runs one configuration per kernel, --filter keeps\n"
+                     "the benchmarks whose name contains the given text, --output writes to a file.",
+                     [](const juce::ArgumentList& args)
+                     {
+                         std::ofstream file;
+                         if (args.containsOption("--output"))
+                         {
+                             file.open(args.getValueForOption("--output").toStdString());
+                             if (!file)
+                             {
+                                 juce::ConsoleApplication::fail("Could not write to " + args.getValueForOption("--output"));
+                             }
+                         }
+
+                         Benchmark benchmark(file.is_open() ? file : std::cout);
+                         benchmark.setQuick(args.containsOption("--quick"));
+                         benchmark.setFilter(args.getValueForOption("--filter"));
+                         benchmark.run();
+                     } });
+
+    app.addCommand({ "golden",
+                     "golden --output=folder [--quick]",
+                     "Renders the impulse and noise responses of the processor as reference WAV files.",
+                     "Renders every preset at every sample rate, and at 48 kHz on every other engine, into the\n"
+                     "folder, one 32-bit float WAV file per case, for verify to compare later builds against.\n"
+                     "--quick renders the default engine at 48 kHz only.",
+                     [](const juce::ArgumentList& args)
+                     {
+                         auto folder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+                         GoldenCheck check(std::cout);
+                         check.setQuick(args.containsOption("--quick"));
+                         if (!check.write(folder))
+                         {
+                             juce::ConsoleApplication::fail("Could not write to " + folder.getFullPathName());
+                         }
+                     } });
+
+    app.addCommand({ "verify",
+                     "verify --reference=folder [--quick] [--exact] [--max-error=x] [--max-envelope-db=x]",
+                     "Compares the responses of the processor with the files golden wrote.",
+                     "Renders the same cases again and prints whether each is bit-exact, its largest sample\n"
+                     "difference and its largest third-octave envelope deviation in dB. A case fails when it\n"
+                     "misses a tolerance, --exact fails every case that is not bit-exact. The envelope\n"
+                     "tolerance is 3 dB unless --max-envelope-db says otherwise, the sample difference is\n"
+                     "only checked with --max-error. Exits with 1 when any case fails.",
+                     [](const juce::ArgumentList& args)
+                     {
+                         auto folder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--reference"));
+                         GoldenCheck check(std::cout);
+                         check.setQuick(args.containsOption("--quick"));
+                         check.setExact(args.containsOption("--exact"));
+                         if (args.containsOption("--max-error"))
+                         {
+                             check.setMaxError(args.getValueForOption("--max-error").getDoubleValue());
+                         }
+                         if (args.containsOption("--max-envelope-db"))
+                         {
+                             check.setMaxEnvelopeDeviation(args.getValueForOption("--max-envelope-db").getDoubleValue());
+                         }
+
+                         auto failures = check.verify(folder);
+                         if (failures > 0)
+                         {
+                             juce::ConsoleApplication::fail(juce::String(failures) + " cases failed");
+                         }
+                     } });
+
+    app.addCommand({ "storage",
+                     "storage [--sample-rate=n]",
+                     "Measures the SNR of the half-float and int16 delay storage against float.",
+                     "Renders four parameter sets with the feedback lines in every storage format on an\n"
+                     "impulse and two noise bursts, at 44.1 kHz unless --sample-rate says otherwise, and prints\n"
+                     "the SNR of each format against the float render, one CSV line per render.",
+                     [](const juce::ArgumentList& args)
+                     {
+                         StorageCheck check(std::cout);
+                         if (args.containsOption("--sample-rate"))
+                         {
+                             check.setSampleRate(args.getValueForOption("--sample-rate").getDoubleValue());
+                         }
+                         if (!check.run())
+                         {
+                             juce::ConsoleApplication::fail("A preset names an unknown parameter");
+                         }
+                     } });
+
+    app.addCommand({ "render",
+                     "render --output=folder [--block-size=n] [--jobs=n] [--tail=seconds] [--parameters=Name=value,...] files...",
+                     "Streams audio files through the processor into WAV files, several files at once.",
+                     "Every file is read, processed and written on a thread of its own, so long files stream\n"
+                     "through at the speed of the DSP. --block-size sets the samples per processBlock, 4096\n"
+                     "by default, --jobs the files rendered at once, one per core by default, and --tail the\n"
+                     "seconds of silence rendered after the end, 5 by default. --parameters sets parameters\n"
+                     "by their names in a host, e.g. --parameters=Decay=0.8,Mixing=1.",
+                     [](const juce::ArgumentList& args)
+                     {
+                         auto folder = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+                         OfflineRenderer renderer(std::cout);
+                         if (args.containsOption("--block-size"))
+                         {
+                             renderer.setBlockSize(args.getValueForOption("--block-size").getIntValue());
+                         }
+                         if (args.containsOption("--jobs"))
+                         {
+                             renderer.setNumJobs(args.getValueForOption("--jobs").getIntValue());
+                         }
+                         if (args.containsOption("--tail"))
+                         {
+                             renderer.setTailLength(args.getValueForOption("--tail").getDoubleValue());
+                         }
+
+                         for (auto& parameter : getParameters(args))
+                         {
+                             renderer.setParameter(parameter.first, parameter.second);
+                         }
+
+                         std::vector<juce::File> inputs;
+                         for (int index = 1; index < args.size(); index++)
+                         {
+                             if (!args[index].isOption())
+                             {
+                                 inputs.push_back(args[index].resolveAsFile());
+                             }
+                         }
+                         if (inputs.empty())
+                         {
+                             juce::ConsoleApplication::fail("No input files");
+                         }
+
+                         auto failures = renderer.renderAll(inputs, folder);
+                         if (failures > 0)
+                         {
+                             juce::ConsoleApplication::fail(juce::String(failures) + " files failed");
+                         }
+                     } });
+
+    app.addCommand({ "dataset",
+                     "dataset --output=file.pirs [--grid=Name=start:end:count,Name=a/b/c] [--points=file.csv] [--length=seconds] [--sample-rate=n] [--channels=n] [--jobs=n] [--cache=folder] [--cache-size=MB]",
+                     "Renders the impulse response of every point of a parameter grid into one file.",
+                     "--grid spans evenly spaced values with start:end:count or lists them with a/b/c, and\n"
+                     "renders every combination. --points reads the points from a CSV file instead, the\n"
+                     "parameter names in the first line. Parameters left out keep their defaults. The\n"
+                     "responses are --length seconds long, 1 by default, at 48 kHz in stereo unless\n"
+                     "--sample-rate and --channels say otherwise. The file holds a header, the parameter\n"
+                     "table and one record of float samples per point, see DatasetGenerator.h. --cache\n"
+                     "reuses the responses kept in a folder and keeps the new ones there, see response.",
+                     [](const juce::ArgumentList& args)
+                     {
+                         DatasetGenerator generator(std::cout);
+                         auto cache = createCache(args);
+                         generator.setCache(cache.get());
+                         if (args.containsOption("--length"))
+                         {
+                             generator.setLength(args.getValueForOption("--length").getDoubleValue());
+                         }
+                         if (args.containsOption("--sample-rate"))
+                         {
+                             generator.setSampleRate(args.getValueForOption("--sample-rate").getDoubleValue());
+                         }
+                         if (args.containsOption("--channels"))
+                         {
+                             generator.setNumChannels(args.getValueForOption("--channels").getIntValue());
+                         }
+                         if (args.containsOption("--jobs"))
+                         {
+                             generator.setNumJobs(args.getValueForOption("--jobs").getIntValue());
+                         }
+
+                         for (auto& axis : juce::StringArray::fromTokens(args.getValueForOption("--grid"), ",", ""))
+                         {
+                             if (!generator.addAxis(axis))
+                             {
+                                 juce::ConsoleApplication::fail("Could not use the axis " + axis + ", parameters are "
+                                                                + OfflineProcessor::getParameterNames().joinIntoString(", "));
+                             }
+                         }
+                         if (args.containsOption("--points"))
+                         {
+                             auto points = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--points"));
+                             if (!generator.addPoints(points))
+                             {
+                                 juce::ConsoleApplication::fail("Could not use the points in " + points.getFullPathName());
+                             }
+                         }
+
+                         auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+                         if (!generator.generate(file))
+                         {
+                             juce::ConsoleApplication::fail("Could not write " + file.getFullPathName());
+                         }
+                     } });
+
+    app.addCommand({ "response",
+                     "response --output=file.wav [--parameters=Name=value,...] [--length=seconds] [--sample-rate=n] [--channels=n] [--cache=folder] [--cache-size=MB]",
+                     "Renders the impulse response of one setting of the parameters into a WAV file.",
+                     "The response starts from silence with a unit impulse on every channel and is --length\n"
+                     "seconds long, 2 by default, at 48 kHz in stereo unless --sample-rate and --channels say\n"
+                     "otherwise. --parameters sets parameters by their names in a host, the rest keep their\n"
+                     "defaults. With --cache the response is read from that folder when an earlier run kept it\n"
+                     "there, and rendered and kept otherwise. The folder stays within --cache-size MB, 1024 by\n"
+                     "default, the least recently used responses go first.",
+                     [](const juce::ArgumentList& args)
+                     {
+                         auto sampleRate = args.containsOption("--sample-rate") ? args.getValueForOption("--sample-rate").getDoubleValue() : 48000.0;
+                         auto numChannels = args.containsOption("--channels") ? juce::jmax(1, args.getValueForOption("--channels").getIntValue()) : 2;
+                         auto seconds = args.containsOption("--length") ? args.getValueForOption("--length").getDoubleValue() : 2.0;
+                         auto length = juce::jmax(1, (int)(seconds * sampleRate));
+
+                         OfflineProcessor processor(sampleRate, numChannels, 512);
+                         for (auto& parameter : getParameters(args))
+                         {
+                             processor.setParameter(parameter.first, parameter.second);
+                         }
+                         // --- keyed on the values the processor took, as dataset does, so both find each other's responses
+                         auto cache = createCache(args);
+                         auto key = ResponseCache::getKey(OfflineProcessor::getParameterNames(), processor.getParameters(), sampleRate, numChannels, length, processor.getConfiguration());
+                         auto cached = cache != nullptr ? cache->find(key) : nullptr;
+                         juce::AudioBuffer<float> buffer;
+                         if (cached == nullptr)
+                         {
+                             buffer.setSize(numChannels, length);
+                             processor.renderImpulseResponse(buffer);
+                             if (cache != nullptr)
+                             {
+                                 cache->store(key, buffer.getArrayOfReadPointers(), numChannels, length);
+                             }
+                         }
+                         auto* samples = cached != nullptr ? cached->getArrayOfReadPointers() : buffer.getArrayOfReadPointers();
+
+                         auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+                         file.deleteFile();
+                         std::unique_ptr<juce::FileOutputStream> stream(file.createOutputStream());
+                         juce::WavAudioFormat format;
+                         std::unique_ptr<juce::AudioFormatWriter> writer(stream == nullptr ? nullptr : format.createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, 32, {}, 0));
+                         if (writer == nullptr)
+                         {
+                             juce::ConsoleApplication::fail("Could not write " + file.getFullPathName());
+                         }
+                         // --- the writer owns the stream from here on
+                         stream.release();
+                         if (!writer->writeFromFloatArrays(samples, numChannels, length))
+                         {
+                             juce::ConsoleApplication::fail("Could not write " + file.getFullPathName());
+                         }
+                         std::cout << file.getFullPathName() << (cached != nullptr ? ", from the cache" : ", rendered") << std::endl;
+                     } });
+
+    return app.findAndRunCommand(argc, argv);
+}
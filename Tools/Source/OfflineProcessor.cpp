@@ -0,0 +1,111 @@
+//
+//  OfflineProcessor.cpp
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#include "OfflineProcessor.h"
+
+OfflineProcessor::OfflineProcessor(double sampleRate, int numChannels, int blockSize, const PuannhiAudioProcessor::EngineOptions& engine)
+{
+    mBlockSize = blockSize;
+    // --- no helper threads, see the class comment
+    auto options = engine;
+    options.maxWorkerThreads = 0;
+    mProcessor.setEngineOptions(options);
+    mProcessor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+    mProcessor.prepareToPlay(sampleRate, blockSize);
+}
+
+bool OfflineProcessor::setParameter(const juce::String& name, float value)
+{
+    for (auto* parameter : mProcessor.getParameters())
+    {
+        auto* floatParameter = dynamic_cast<juce::AudioParameterFloat*>(parameter);
+        if (floatParameter != nullptr && floatParameter->getName(64) == name)
+        {
+            *floatParameter = value;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool OfflineProcessor::setParameters(const Preset& preset)
+{
+    bool known = true;
+    for (auto& value : preset.values)
+    {
+        known = setParameter(value.first, value.second) && known;
+    }
+    return known;
+}
+
+float OfflineProcessor::getParameter(const juce::String& name)
+{
+    for (auto* parameter : mProcessor.getParameters())
+    {
+        auto* floatParameter = dynamic_cast<juce::AudioParameterFloat*>(parameter);
+        if (floatParameter != nullptr && floatParameter->getName(64) == name)
+        {
+            return floatParameter->get();
+        }
+    }
+    return 0;
+}
+
+std::vector<float> OfflineProcessor::getParameters()
+{
+    std::vector<float> values;
+    for (auto* parameter : mProcessor.getParameters())
+    {
+        auto* floatParameter = dynamic_cast<juce::AudioParameterFloat*>(parameter);
+        values.push_back(floatParameter != nullptr ? floatParameter->get() : 0.0f);
+    }
+    return values;
+}
+
+void OfflineProcessor::reset()
+{
+    mProcessor.reset();
+}
+
+void OfflineProcessor::process(juce::AudioBuffer<float>& buffer)
+{
+    auto numChannels = buffer.getNumChannels();
+    for (int start = 0; start < buffer.getNumSamples(); start += mBlockSize)
+    {
+        auto numSamples = juce::jmin(mBlockSize, buffer.getNumSamples() - start);
+        juce::AudioBuffer<float> block(buffer.getArrayOfWritePointers(), numChannels, start, numSamples);
+        mProcessor.processBlock(block, mMidi);
+    }
+}
+
+void OfflineProcessor::renderImpulseResponse(juce::AudioBuffer<float>& buffer)
+{
+    reset();
+    buffer.clear();
+    for (int channel = 0; channel < buffer.getNumChannels(); channel++)
+    {
+        buffer.setSample(channel, 0, 1);
+    }
+    process(buffer);
+}
+
+juce::String OfflineProcessor::getConfiguration() const
+{
+    return mProcessor.getConfiguration();
+}
+
+juce::StringArray OfflineProcessor::getParameterNames()
+{
+    PuannhiAudioProcessor processor;
+    juce::StringArray names;
+    for (auto* parameter : processor.getParameters())
+    {
+        names.add(parameter->getName(64));
+    }
+    return names;
+}
@@ -0,0 +1,61 @@
+//
+//  OfflineProcessor.h
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef OfflineProcessor_h
+#define OfflineProcessor_h
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+// PuannhiAudioProcessor driven the way a host would, without one: prepared for a sample
+// rate, channel count, block size and engine, parameters set by their names, and whole
+// buffers processed block by block in place. It never starts helper threads, whatever the
+// engine asks for, so callers that run one processor per thread keep the machine to those.
+class OfflineProcessor
+{
+
+public:
+    // --- a named set of parameter values, by the names the parameters show in a host
+    struct Preset
+    {
+        juce::String name;
+        std::vector<std::pair<juce::String, float>> values;
+    };
+
+    OfflineProcessor(double sampleRate, int numChannels, int blockSize, const PuannhiAudioProcessor::EngineOptions& engine = {});
+
+    ~OfflineProcessor()
+    {
+        mProcessor.releaseResources();
+    };
+
+    // --- by the name the parameter shows in a host, e.g. "Decay", returns false for unknown names
+    bool setParameter(const juce::String& name, float value);
+    // --- every value of preset, returns false when one of its names is unknown
+    bool setParameters(const Preset& preset);
+    // --- the current value, zero for unknown names
+    float getParameter(const juce::String& name);
+    // --- the current values of every parameter, in the order of getParameterNames()
+    std::vector<float> getParameters();
+    // --- clears the tails, the next buffer starts from silence
+    void reset();
+    void process(juce::AudioBuffer<float>& buffer);
+    // --- from silence, a unit impulse on every channel, as long as the buffer
+    void renderImpulseResponse(juce::AudioBuffer<float>& buffer);
+    // --- see PuannhiAudioProcessor::getConfiguration()
+    juce::String getConfiguration() const;
+
+    static juce::StringArray getParameterNames();
+
+private:
+    PuannhiAudioProcessor mProcessor;
+    int mBlockSize;
+    juce::MidiBuffer mMidi;
+};
+
+#endif /* OfflineProcessor_h */
@@ -0,0 +1,245 @@
+//
+//  OfflineRenderer.cpp
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#include "OfflineRenderer.h"
+#include "OfflineProcessor.h"
+#include <atomic>
+
+void OfflineRenderer::BlockQueue::push(int block)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mBlocks.push_back(block);
+    }
+    mReady.notify_one();
+}
+
+int OfflineRenderer::BlockQueue::pop()
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mReady.wait(lock, [this] { return !mBlocks.empty(); });
+    int block = mBlocks.front();
+    mBlocks.pop_front();
+    return block;
+}
+
+void OfflineRenderer::setBlockSize(int blockSize)
+{
+    mBlockSize = juce::jmax(1, blockSize);
+}
+
+void OfflineRenderer::setTailLength(double seconds)
+{
+    mTailLength = juce::jmax(0.0, seconds);
+}
+
+void OfflineRenderer::setNumJobs(int numJobs)
+{
+    mNumJobs = juce::jmax(1, numJobs);
+}
+
+void OfflineRenderer::setParameter(const juce::String& name, float value)
+{
+    mParameters.push_back({ name, value });
+}
+
+int OfflineRenderer::renderAll(const std::vector<juce::File>& inputs, const juce::File& folder)
+{
+    if (!folder.createDirectory())
+    {
+        report("Could not create " + folder.getFullPathName());
+        return (int)inputs.size();
+    }
+
+    // --- every job takes the next file that nobody has taken yet, the calling thread is one of them
+    std::atomic<int> next { 0 };
+    std::atomic<int> failures { 0 };
+    auto job = [&]
+    {
+        for (int index = next++; index < (int)inputs.size(); index = next++)
+        {
+            auto output = folder.getChildFile(inputs[index].getFileNameWithoutExtension() + ".wav");
+            if (!render(inputs[index], output))
+            {
+                failures++;
+            }
+        }
+    };
+
+    std::vector<std::thread> jobs;
+    for (int index = 1; index < juce::jmin(mNumJobs, (int)inputs.size()); index++)
+    {
+        jobs.emplace_back(job);
+    }
+    job();
+    for (auto& thread : jobs)
+    {
+        thread.join();
+    }
+    return failures;
+}
+
+bool OfflineRenderer::render(const juce::File& input, const juce::File& output)
+{
+    if (input == output)
+    {
+        report(input.getFullPathName() + ": the output would overwrite the input");
+        return false;
+    }
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    auto reader = createReader(formats, input);
+    if (reader == nullptr)
+    {
+        report(input.getFullPathName() + ": not a readable audio file");
+        return false;
+    }
+
+    auto sampleRate = reader->sampleRate;
+    auto numChannels = (int)reader->numChannels;
+    auto length = reader->lengthInSamples + (juce::int64)(mTailLength * sampleRate);
+    // --- keep integer files at their depth, everything else becomes 32-bit float
+    auto bitsPerSample = (int)reader->bitsPerSample;
+    if (reader->usesFloatingPointData || (bitsPerSample != 16 && bitsPerSample != 24))
+    {
+        bitsPerSample = 32;
+    }
+
+    output.deleteFile();
+    std::unique_ptr<juce::FileOutputStream> stream(output.createOutputStream());
+    if (stream == nullptr)
+    {
+        report(output.getFullPathName() + ": could not be written");
+        return false;
+    }
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatWriter> writer(format.createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, bitsPerSample, {}, 0));
+    if (writer == nullptr)
+    {
+        report(output.getFullPathName() + ": no WAV format for " + juce::String(numChannels) + " channels");
+        return false;
+    }
+    // --- the writer owns the stream from here on
+    stream.release();
+
+    OfflineProcessor processor(sampleRate, numChannels, mBlockSize);
+    for (auto& parameter : mParameters)
+    {
+        processor.setParameter(parameter.first, parameter.second);
+    }
+    processor.reset();
+
+    Block blocks[kQueueDepth];
+    BlockQueue empty, filled, processed;
+    for (int index = 0; index < kQueueDepth; index++)
+    {
+        blocks[index].buffer.setSize(numChannels, mBlockSize);
+        empty.push(index);
+    }
+
+    // --- a failing stage keeps passing blocks on, so the others run to the end marker and stop
+    std::atomic<bool> failed { false };
+    auto start = juce::Time::getHighResolutionTicks();
+
+    // --- reads past the end of the input come back as silence, which is the tail
+    std::thread readerThread([&]
+    {
+        for (juce::int64 position = 0; ; position += mBlockSize)
+        {
+            auto index = empty.pop();
+            auto& block = blocks[index];
+            block.numSamples = (int)juce::jmin((juce::int64)mBlockSize, length - position);
+            if (block.numSamples <= 0 || failed)
+            {
+                block.numSamples = 0;
+                filled.push(index);
+                return;
+            }
+            if (!reader->read(&block.buffer, 0, block.numSamples, position, true, true))
+            {
+                failed = true;
+            }
+            filled.push(index);
+        }
+    });
+
+    std::thread writerThread([&]
+    {
+        while (true)
+        {
+            auto index = processed.pop();
+            auto& block = blocks[index];
+            if (block.numSamples == 0)
+            {
+                return;
+            }
+            if (!failed && !writer->writeFromAudioSampleBuffer(block.buffer, 0, block.numSamples))
+            {
+                failed = true;
+            }
+            empty.push(index);
+        }
+    });
+
+    while (true)
+    {
+        // --- the block belongs to the next stage once it is pushed, so its length is read before
+        auto index = filled.pop();
+        auto numSamples = blocks[index].numSamples;
+        if (numSamples > 0)
+        {
+            juce::AudioBuffer<float> samples(blocks[index].buffer.getArrayOfWritePointers(), numChannels, 0, numSamples);
+            processor.process(samples);
+        }
+        processed.push(index);
+        if (numSamples == 0)
+        {
+            break;
+        }
+    }
+
+    readerThread.join();
+    writerThread.join();
+    // --- closes the file and finishes its header
+    writer.reset();
+
+    if (failed)
+    {
+        report(input.getFullPathName() + ": failed while streaming");
+        output.deleteFile();
+        return false;
+    }
+
+    auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    report(input.getFullPathName() + " -> " + output.getFullPathName()
+           + ", " + juce::String(length / sampleRate, 1) + " s of audio in " + juce::String(seconds, 1)
+           + " s, " + juce::String(length / sampleRate / seconds, 1) + "x realtime");
+    return true;
+}
+
+std::unique_ptr<juce::AudioFormatReader> OfflineRenderer::createReader(juce::AudioFormatManager& formats, const juce::File& file)
+{
+    // --- WAV and AIFF map straight into memory, the page cache does the read-ahead and no copy
+    // --- is made on the way in. Compressed formats decode from a stream instead
+    if (auto* format = formats.findFormatForFileExtension(file.getFileExtension()))
+    {
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> mapped(format->createMemoryMappedReader(file));
+        if (mapped != nullptr && mapped->mapEntireFile())
+        {
+            return mapped;
+        }
+    }
+    return std::unique_ptr<juce::AudioFormatReader>(formats.createReaderFor(file));
+}
+
+void OfflineRenderer::report(const juce::String& line)
+{
+    std::lock_guard<std::mutex> lock(mOutputMutex);
+    mOutput << line << std::endl;
+}
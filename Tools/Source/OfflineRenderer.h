@@ -0,0 +1,92 @@
+//
+//  OfflineRenderer.h
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef OfflineRenderer_h
+#define OfflineRenderer_h
+
+#include <JuceHeader.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <thread>
+
+// Streams audio files through the processor, no host needed. Each file runs as a pipeline of
+// three threads:
+//  - a reader, which maps the file into memory where the format allows it and otherwise reads
+//    ahead from the stream
+//  - the DSP thread
+//  - a writer
+// The threads hand blocks to each other through bounded queues. Only kQueueDepth blocks of a
+// file are in flight, so memory stays the same for hours of audio, and a slow disk stalls the
+// reader instead of filling memory. renderAll() renders several files at once, one file per
+// job, so the cores stay busy with DSP while the disk catches up.
+class OfflineRenderer
+{
+
+public:
+    OfflineRenderer(std::ostream& output)
+        : mOutput(output)
+    {
+        mBlockSize = 4096;
+        mTailLength = 5;
+        mNumJobs = juce::jmax(1, (int)std::thread::hardware_concurrency());
+    };
+
+    ~OfflineRenderer()
+    {
+    };
+
+    void setBlockSize(int blockSize);
+    // --- seconds of silence fed after the end of every input, so the tail rings out
+    void setTailLength(double seconds);
+    // --- files rendered at the same time
+    void setNumJobs(int numJobs);
+    // --- by the name the parameter shows in a host, for every file
+    void setParameter(const juce::String& name, float value);
+
+    // --- renders every input into the folder as a WAV file with the same name, returns the number that failed
+    int renderAll(const std::vector<juce::File>& inputs, const juce::File& folder);
+    bool render(const juce::File& input, const juce::File& output);
+
+    static const int kQueueDepth = 4;
+
+private:
+    // --- indices of blocks waiting for the next stage, pop() blocks until there is one
+    class BlockQueue
+    {
+
+    public:
+        void push(int block);
+        int pop();
+
+    private:
+        std::mutex mMutex;
+        std::condition_variable mReady;
+        std::deque<int> mBlocks;
+    };
+
+    struct Block
+    {
+        juce::AudioBuffer<float> buffer;
+        // --- zero marks the end of the file
+        int numSamples;
+    };
+
+    static std::unique_ptr<juce::AudioFormatReader> createReader(juce::AudioFormatManager& formats, const juce::File& file);
+    void report(const juce::String& line);
+
+    std::ostream& mOutput;
+    std::mutex mOutputMutex;
+    int mBlockSize;
+    double mTailLength;
+    int mNumJobs;
+    std::vector<std::pair<juce::String, float>> mParameters;
+};
+
+#endif /* OfflineRenderer_h */
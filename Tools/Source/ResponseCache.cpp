@@ -0,0 +1,204 @@
+//
+//  ResponseCache.cpp
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#include "ResponseCache.h"
+#include <algorithm>
+
+int ResponseCache::Response::getNumChannels() const
+{
+    return (int)mChannels.size();
+}
+
+int ResponseCache::Response::getNumSamples() const
+{
+    return mNumSamples;
+}
+
+const float* ResponseCache::Response::getReadPointer(int channel) const
+{
+    return mChannels[channel];
+}
+
+const float* const* ResponseCache::Response::getArrayOfReadPointers() const
+{
+    return mChannels.data();
+}
+
+ResponseCache::ResponseCache(const juce::File& folder, juce::int64 maxBytes)
+    : mFolder(folder), mMaxBytes(maxBytes)
+{
+    mNumBytes = 0;
+    mFolder.createDirectory();
+
+    // --- the files already there, least recently used first, each touched in turn ends up in order
+    auto files = mFolder.findChildFiles(juce::File::findFiles, false, "*.pirc");
+    std::sort(files.begin(), files.end(), [](const juce::File& a, const juce::File& b)
+    {
+        return a.getLastModificationTime() < b.getLastModificationTime();
+    });
+    for (auto& file : files)
+    {
+        auto key = (uint64_t)file.getFileNameWithoutExtension().getHexValue64();
+        if (getFile(key) == file)
+        {
+            touch(key, file.getSize());
+        }
+    }
+    evict();
+}
+
+uint64_t ResponseCache::getKey(const juce::StringArray& names, const std::vector<float>& values, double sampleRate, int numChannels, int numSamples, const juce::String& configuration)
+{
+    // --- 64-bit FNV-1a over the bytes of every field
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](const void* data, size_t numBytes)
+    {
+        for (size_t index = 0; index < numBytes; index++)
+        {
+            hash = (hash ^ static_cast<const uint8_t*>(data)[index]) * 1099511628211ull;
+        }
+    };
+
+    int version = kVersion;
+    add(&version, sizeof(version));
+    for (int index = 0; index < names.size(); index++)
+    {
+        auto name = names[index].toStdString();
+        add(name.c_str(), name.size() + 1);
+        float value = index < (int)values.size() ? values[index] : 0.0f;
+        add(&value, sizeof(value));
+    }
+    add(&sampleRate, sizeof(sampleRate));
+    add(&numChannels, sizeof(numChannels));
+    add(&numSamples, sizeof(numSamples));
+    auto text = configuration.toStdString();
+    add(text.c_str(), text.size() + 1);
+    return hash;
+}
+
+std::unique_ptr<ResponseCache::Response> ResponseCache::find(uint64_t key)
+{
+    auto file = getFile(key);
+    std::unique_ptr<juce::MemoryMappedFile> mapped(new juce::MemoryMappedFile(file, juce::MemoryMappedFile::readOnly));
+    auto* data = static_cast<const char*>(mapped->getData());
+    auto size = (juce::int64)mapped->getSize();
+
+    // --- a file that is missing, cut short or not what it claims to be is a miss
+    int version = 0;
+    juce::int64 fileKey = 0;
+    int numChannels = 0;
+    int numSamples = 0;
+    if (data != nullptr && size >= kHeaderSize && memcmp(data, "PIRC", 4) == 0)
+    {
+        memcpy(&version, data + 4, sizeof(version));
+        memcpy(&fileKey, data + 8, sizeof(fileKey));
+        memcpy(&numChannels, data + 16, sizeof(numChannels));
+        memcpy(&numSamples, data + 20, sizeof(numSamples));
+    }
+    if (data == nullptr || version != kVersion || (uint64_t)fileKey != key || numChannels <= 0 || numSamples <= 0
+        || size != kHeaderSize + (juce::int64)numChannels * numSamples * (juce::int64)sizeof(float))
+    {
+        mMisses++;
+        return nullptr;
+    }
+
+    std::unique_ptr<Response> response(new Response());
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        response->mChannels.push_back(reinterpret_cast<const float*>(data + kHeaderSize) + (juce::int64)channel * numSamples);
+    }
+    response->mNumSamples = numSamples;
+    response->mFile = std::move(mapped);
+
+    file.setLastModificationTime(juce::Time::getCurrentTime());
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        touch(key, size);
+    }
+    mHits++;
+    return response;
+}
+
+bool ResponseCache::store(uint64_t key, const float* const* channels, int numChannels, int numSamples)
+{
+    // --- written next to its place and moved there whole, so no reader maps half a file
+    auto file = getFile(key);
+    juce::TemporaryFile temporary(file);
+    {
+        juce::FileOutputStream stream(temporary.getFile());
+        if (stream.failedToOpen())
+        {
+            return false;
+        }
+        stream.write("PIRC", 4);
+        stream.writeInt(kVersion);
+        stream.writeInt64((juce::int64)key);
+        stream.writeInt(numChannels);
+        stream.writeInt(numSamples);
+        for (int channel = 0; channel < numChannels; channel++)
+        {
+            stream.write(channels[channel], (size_t)numSamples * sizeof(float));
+        }
+        stream.flush();
+        if (stream.getStatus().failed())
+        {
+            return false;
+        }
+    }
+    if (!temporary.overwriteTargetFileWithTemporary())
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    touch(key, kHeaderSize + (juce::int64)numChannels * numSamples * sizeof(float));
+    evict();
+    return true;
+}
+
+int ResponseCache::getNumHits() const
+{
+    return mHits;
+}
+
+int ResponseCache::getNumMisses() const
+{
+    return mMisses;
+}
+
+juce::File ResponseCache::getFile(uint64_t key) const
+{
+    return mFolder.getChildFile(juce::String::toHexString((juce::int64)key).paddedLeft('0', 16) + ".pirc");
+}
+
+void ResponseCache::touch(uint64_t key, juce::int64 numBytes)
+{
+    auto entry = mEntries.find(key);
+    if (entry != mEntries.end())
+    {
+        mOrder.erase(entry->second.first);
+        mNumBytes -= entry->second.second;
+    }
+    mOrder.push_front(key);
+    mEntries[key] = { mOrder.begin(), numBytes };
+    mNumBytes += numBytes;
+}
+
+void ResponseCache::evict()
+{
+    // --- the newest entry always stays. A file another process still maps may refuse to go on
+    // --- some systems, it is forgotten all the same
+    while (mNumBytes > mMaxBytes && mOrder.size() > 1)
+    {
+        auto key = mOrder.back();
+        getFile(key).deleteFile();
+        mNumBytes -= mEntries[key].second;
+        mEntries.erase(key);
+        mOrder.pop_back();
+    }
+}
@@ -0,0 +1,99 @@
+//
+//  ResponseCache.h
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef ResponseCache_h
+#define ResponseCache_h
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+
+// Rendered impulse responses kept on disk, so previews and batch jobs that ask for the same
+// response again read it instead of running the network. The key is a hash of everything the
+// response depends on: every parameter by name and value, the sample rate, the channels, the
+// length and the configuration the processor was built and set up with, see
+// PuannhiAudioProcessor::getConfiguration(). Each response is one file in the folder, named after its key:
+//
+//     char[4]   "PIRC"
+//     int32     version, 2
+//     int64     key
+//     int32     number of channels
+//     int32     samples per channel
+//     float32   samples of every channel, channel by channel
+//
+// A found response is the file mapped into memory, read in place with no copy. The folder is
+// held to a size budget by deleting the least recently used files first. The order comes from
+// the modification times when the cache opens, and every hit and store moves a file to the
+// front and stamps it, so other processes sharing the folder see the same order.
+//
+// The configuration covers the compile-time switches and the engine options, not the code
+// itself, so bump kVersion, or clear the folder, when a change to the DSP changes its output.
+class ResponseCache
+{
+
+public:
+    // --- a cached response, mapped read-only for as long as the object lives
+    class Response
+    {
+
+    public:
+        int getNumChannels() const;
+        int getNumSamples() const;
+        const float* getReadPointer(int channel) const;
+        const float* const* getArrayOfReadPointers() const;
+
+    private:
+        friend class ResponseCache;
+
+        std::unique_ptr<juce::MemoryMappedFile> mFile;
+        std::vector<const float*> mChannels;
+        int mNumSamples = 0;
+    };
+
+    ResponseCache(const juce::File& folder, juce::int64 maxBytes);
+
+    ~ResponseCache()
+    {
+    };
+
+    static uint64_t getKey(const juce::StringArray& names, const std::vector<float>& values, double sampleRate, int numChannels, int numSamples, const juce::String& configuration);
+
+    // --- nullptr when the key is not cached
+    std::unique_ptr<Response> find(uint64_t key);
+    // --- one row of numSamples per channel, then evicts down to the budget
+    bool store(uint64_t key, const float* const* channels, int numChannels, int numSamples);
+
+    int getNumHits() const;
+    int getNumMisses() const;
+
+    static const int kVersion = 2;
+    static const int kHeaderSize = 24;
+
+private:
+    juce::File getFile(uint64_t key) const;
+    // --- moves key to the front of the order, adding it with its size when it is new
+    void touch(uint64_t key, juce::int64 numBytes);
+    // --- deletes the least recently used files until the rest fits the budget
+    void evict();
+
+    juce::File mFolder;
+    juce::int64 mMaxBytes;
+
+    // --- most recently used first, and the place and size of every key in it
+    std::mutex mMutex;
+    std::list<uint64_t> mOrder;
+    std::map<uint64_t, std::pair<std::list<uint64_t>::iterator, juce::int64>> mEntries;
+    juce::int64 mNumBytes;
+
+    std::atomic<int> mHits { 0 };
+    std::atomic<int> mMisses { 0 };
+};
+
+#endif /* ResponseCache_h */
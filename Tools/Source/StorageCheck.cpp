@@ -0,0 +1,98 @@
+//
+//  StorageCheck.cpp
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#include "StorageCheck.h"
+
+namespace
+{
+    const int numChannels = 2;
+    const int blockSize = 512;
+    const double renderTime = 4;
+    const double burstTime = 0.05;
+    const double burstStarts[] = { 1, 2 };
+    const char* storageNames[] = { "float", "half_float", "dithered_int16" };
+}
+
+void StorageCheck::setSampleRate(double sampleRate)
+{
+    mSampleRate = sampleRate;
+}
+
+bool StorageCheck::run()
+{
+    // --- fully wet, from a small bright room at full decay, where the lines carry the most
+    // --- energy, to a large dark one
+    static const OfflineProcessor::Preset presets[] =
+    {
+        { "small_bright", { { "Mixing", 1 }, { "Pre-Delay", 0 }, { "Brightness", 5000 }, { "Damping",    0 }, { "Decay",    1 }, { "Size", 0.1f }, { "Speed",    1 }, { "Depth", 40 } } },
+        { "medium",       { { "Mixing", 1 }, { "Pre-Delay", 0 }, { "Brightness", 2000 }, { "Damping", 0.3f }, { "Decay", 0.7f }, { "Size", 0.5f }, { "Speed",    1 }, { "Depth", 40 } } },
+        { "large",        { { "Mixing", 1 }, { "Pre-Delay", 0 }, { "Brightness", 1000 }, { "Damping", 0.5f }, { "Decay", 0.5f }, { "Size",    1 }, { "Speed",    1 }, { "Depth", 40 } } },
+        { "large_dark",   { { "Mixing", 1 }, { "Pre-Delay", 0 }, { "Brightness",  300 }, { "Damping", 0.9f }, { "Decay", 0.3f }, { "Size",    1 }, { "Speed", 0.5f }, { "Depth", 20 } } },
+    };
+
+    mOutput << "preset,storage,snr_db" << std::endl;
+    for (auto& preset : presets)
+    {
+        auto reference = render(preset, E_FLOAT_STORAGE);
+        if (reference.getNumChannels() == 0)
+        {
+            mOutput << preset.name << ", unknown parameter" << std::endl;
+            return false;
+        }
+        for (int storage = E_HALF_FLOAT_STORAGE; storage <= E_DITHERED_INT16_STORAGE; storage++)
+        {
+            auto test = render(preset, storage);
+            double signal = 0;
+            double noise = 0;
+            for (int channel = 0; channel < numChannels; channel++)
+            {
+                auto* a = reference.getReadPointer(channel);
+                auto* b = test.getReadPointer(channel);
+                for (int i = 0; i < reference.getNumSamples(); i++)
+                {
+                    signal += (double)a[i] * a[i];
+                    noise += ((double)a[i] - b[i]) * ((double)a[i] - b[i]);
+                }
+            }
+            auto snr = noise > 0 ? 10 * std::log10(signal / noise) : std::numeric_limits<double>::infinity();
+            mOutput << preset.name << "," << storageNames[storage] << "," << juce::String(snr, 1) << std::endl;
+        }
+    }
+    return true;
+}
+
+juce::AudioBuffer<float> StorageCheck::render(const OfflineProcessor::Preset& preset, int storage)
+{
+    PuannhiAudioProcessor::EngineOptions engine;
+    engine.feedbackStorage = storage;
+    OfflineProcessor processor(mSampleRate, numChannels, blockSize, engine);
+    if (!processor.setParameters(preset))
+    {
+        return {};
+    }
+    processor.reset();
+
+    // --- the same noise on every render, the impulse and the bursts at the same times
+    juce::AudioBuffer<float> buffer(numChannels, (int)(mSampleRate * renderTime));
+    buffer.clear();
+    juce::Random random(1);
+    for (int channel = 0; channel < numChannels; channel++)
+    {
+        buffer.setSample(channel, 0, 1);
+        for (auto start : burstStarts)
+        {
+            for (int i = 0; i < (int)(mSampleRate * burstTime); i++)
+            {
+                buffer.setSample(channel, (int)(mSampleRate * start) + i, (random.nextFloat() * 2 - 1) * 0.5f);
+            }
+        }
+    }
+
+    processor.process(buffer);
+    return buffer;
+}
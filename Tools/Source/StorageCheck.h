@@ -0,0 +1,51 @@
+//
+//  StorageCheck.h
+//  PuannhiTools
+//
+//  Created by kweiwen tseng on 2026/10/17.
+//  Copyright © 2026 Sikhaa Electronics. All rights reserved.
+//
+
+#ifndef StorageCheck_h
+#define StorageCheck_h
+
+#include <JuceHeader.h>
+#include <ostream>
+#include "OfflineProcessor.h"
+
+// Measures what the reduced-precision storage formats of SampleStorage.h cost in output
+// quality. Every parameter set is rendered with the feedback lines in float, HalfFloat and
+// DitheredInt16 on the same stimulus, a unit impulse followed by two noise bursts, and the
+// output of each format is compared with the float render, one CSV line per render:
+//
+//     preset,storage,snr_db
+//
+// The SNR is the energy of the float render over the energy of the difference, over the
+// whole render and both channels.
+class StorageCheck
+{
+
+public:
+    StorageCheck(std::ostream& output)
+        : mOutput(output)
+    {
+        mSampleRate = 44100;
+    };
+
+    ~StorageCheck()
+    {
+    };
+
+    void setSampleRate(double sampleRate);
+    // --- returns false when a preset names an unknown parameter
+    bool run();
+
+private:
+    // --- an empty buffer when the preset names an unknown parameter
+    juce::AudioBuffer<float> render(const OfflineProcessor::Preset& preset, int storage);
+
+    std::ostream& mOutput;
+    double mSampleRate;
+};
+
+#endif /* StorageCheck_h */